@@ -22,15 +22,36 @@ FURRY_NS_BEGIN
 #include <functional>
 #include <iostream>
 #include <utility>
+#include <chrono>
+#include <typeinfo>
 
 class Channel;
 
 namespace detail {
+	// Type-erased access to the posted (deferred) events of a single event type
+	class FURRY_API PostedQueue {
+	public:
+		virtual ~PostedQueue() {}
+		virtual void dispatchPosted() = 0;
+	};
+
+	// Remembers which event types have posted events waiting for the next Channel::dispatch()
+	void FURRY_API schedulePosted(PostedQueue* queue);
+
 	template <typename tMessage>
-	class ChannelQueue {
+	class ChannelQueue : public PostedQueue {
 	public:
 		typedef std::function<void(const tMessage&)> Handler;
 		typedef std::pair<void*, Handler> HandlerPair;
+		typedef std::vector<HandlerPair> HandlerList;
+
+		typedef std::function<void(Span<const tMessage>)> BatchHandler;
+		typedef std::pair<void*, BatchHandler> BatchHandlerPair;
+		typedef std::vector<BatchHandlerPair> BatchHandlerList;
+
+		typedef std::function<void(Span<tMessage>)> Consumer;
+		typedef std::pair<void*, Consumer> ConsumerPair;
+		typedef std::vector<ConsumerPair> ConsumerList;
 
 		static ChannelQueue& instance() {
 			static ChannelQueue anInstance;
@@ -39,28 +60,229 @@ namespace detail {
 		}
 
 		template <typename tHandler>
-		void add(tHandler* handler) {
-			vector_.push_back(std::make_pair((void*)handler, createHandler(handler)));
+		void add(tHandler* handler, const char* name) {
+			auto entry = std::make_pair((void*)handler, createHandler(handler));
+			stats_.nameHandler(handler, HandlerKind::Message, nameOf<tHandler>(name));
+
+			handlers_.update([&entry](HandlerList& list) {
+				list.push_back(std::move(entry));
+			});
 		}
 
+		// the handler is invoked on the given lane instead of the broadcasting thread
 		template <typename tHandler>
-		void remove(tHandler* handler) {
-			vector_.remove_if(
-				[handler](const HandlerPair& pair) {
-				return (handler == pair.first);
+		void add(tHandler* handler, Lane& lane, Delivery delivery, const char* name) {
+			auto subscription = std::make_shared<LaneSubscription>(delivery);
+
+			Handler forward = [handler, &lane, subscription](const tMessage& message) {
+				if (!subscription->store(message))
+					return; // a delivery is still pending and will pick up this message as well
+
+				lane.send([handler, subscription] {
+					subscription->deliver(handler);
+				});
+			};
+
+			stats_.nameHandler(handler, HandlerKind::Message, nameOf<tHandler>(name));
+
+			{
+				ScopedLock lock(subscriptions_mutex_);
+				lane_subscriptions_.push_back(std::make_pair((void*)handler, subscription));
 			}
-			);
+
+			handlers_.update([handler, &forward](HandlerList& list) {
+				list.push_back(std::make_pair((void*)handler, std::move(forward)));
+			});
+		}
+
+		template <typename tHandler>
+		void remove(tHandler* handler) {
+			handlers_.update([handler](HandlerList& list) {
+				removeFrom(list, handler);
+			});
+
+			stats_.forgetHandler(handler, HandlerKind::Message);
+
+			// deliveries that are still sitting in a lane must not reach the handler anymore
+			ScopedLock lock(subscriptions_mutex_);
+
+			for (auto& pair : lane_subscriptions_)
+				if (pair.first == handler)
+					pair.second->is_alive_.store(false);
+
+			removeFrom(lane_subscriptions_, handler);
+		}
+
+		template <typename tHandler>
+		void addBatch(tHandler* handler, const char* name) {
+			auto entry = std::make_pair((void*)handler, createBatchHandler(handler));
+			stats_.nameHandler(handler, HandlerKind::Batch, nameOf<tHandler>(name));
+
+			batch_handlers_.update([&entry](BatchHandlerList& list) {
+				list.push_back(std::move(entry));
+			});
+		}
+
+		template <typename tHandler>
+		void removeBatch(tHandler* handler) {
+			batch_handlers_.update([handler](BatchHandlerList& list) {
+				removeFrom(list, handler);
+			});
+
+			stats_.forgetHandler(handler, HandlerKind::Batch);
+		}
+
+		template <typename tHandler>
+		void addConsumer(tHandler* handler, const char* name) {
+			auto entry = std::make_pair((void*)handler, createConsumer(handler));
+			stats_.nameHandler(handler, HandlerKind::Consumer, nameOf<tHandler>(name));
+
+			consumers_.update([&entry](ConsumerList& list) {
+				list.push_back(std::move(entry));
+			});
+		}
+
+		template <typename tHandler>
+		void removeConsumer(tHandler* handler) {
+			consumers_.update([handler](ConsumerList& list) {
+				removeFrom(list, handler);
+			});
+
+			stats_.forgetHandler(handler, HandlerKind::Consumer);
 		}
 
 		void broadcast(const tMessage& message) {
-			auto localVector = vector_.copyInternals();
+			FURRY_PROFILE_ZONE("Channel::broadcast");
+
+			// no lock and no copy, the snapshot stays valid even if a handler (un)registers itself
+			auto handlers = handlers_.read();
+
+			if (ChannelMetrics::isEnabled())
+				stats_.recordBroadcast(handlers->size());
+
+			invoke(*handlers, message);
+		}
+
+		template <typename tArg>
+		void post(tArg&& message) {
+			{
+				ScopedLock lock(posted_mutex_);
+				posted_.push_back(std::forward<tArg>(message));
+			}
 
-			for (const auto& pair : localVector)
-				pair.second(message);
+			if (!is_scheduled_.exchange(true))
+				schedulePosted(this);
+		}
+
+		// Only to be called from the thread that runs Channel::dispatch()
+		virtual void dispatchPosted() override {
+			{
+				ScopedLock lock(posted_mutex_);
+				std::swap(posted_, delivering_);
+				is_scheduled_.store(false);
+			}
+
+			if (delivering_.empty())
+				return;
+
+			Span<const tMessage> batch(delivering_.data(), delivering_.size());
+
+			{
+				auto handlers = batch_handlers_.read();
+				invoke(*handlers, batch);
+			}
+
+			{
+				auto handlers = handlers_.read();
+
+				for (const auto& message : batch) {
+					if (ChannelMetrics::isEnabled())
+						stats_.recordBroadcast(handlers->size());
+
+					invoke(*handlers, message);
+				}
+			}
+
+			{
+				// consumers come last and may move out of the events they want to keep
+				auto consumers = consumers_.read();
+				Span<tMessage> owned(delivering_.data(), delivering_.size());
+
+				invoke(*consumers, owned);
+			}
+
+			delivering_.clear(); // keeps the capacity around for the next frame
 		}
 
 	private:
-		ChannelQueue() {
+		typedef std::mutex Mutex;
+		typedef std::lock_guard<Mutex> ScopedLock;
+
+		// Events on their way to a lane handler. The buffers keep their capacity, so after warming
+		// up only the lane message of each burst allocates, not every event.
+		struct LaneSubscription {
+			explicit LaneSubscription(Delivery delivery) : is_alive_(true), delivery_(delivery), is_scheduled_(false) {}
+
+			// returns true if no delivery is pending, i.e. a new one has to be scheduled
+			bool store(const tMessage& message) {
+				ScopedLock lock(mutex_);
+
+				if (delivery_ == Delivery::Latest && !pending_.empty())
+					pending_.front() = message; // replaces the undelivered event in place
+				else
+					pending_.push_back(message);
+
+				bool wasScheduled = is_scheduled_;
+				is_scheduled_ = true;
+				return !wasScheduled;
+			}
+
+			// only called on the lane's thread
+			template <typename tHandler>
+			void deliver(tHandler* handler) {
+				{
+					ScopedLock lock(mutex_);
+					std::swap(pending_, delivering_);
+					is_scheduled_ = false;
+				}
+
+				for (const auto& message : delivering_)
+					if (is_alive_.load())
+						(*handler)(message);
+
+				delivering_.clear();
+			}
+
+			std::atomic<bool> is_alive_;
+			const Delivery delivery_;
+
+			Mutex mutex_;
+			bool is_scheduled_;
+			std::vector<tMessage> pending_;		// filled by broadcasts, from any thread
+			std::vector<tMessage> delivering_;	// the events the lane is currently handing over
+		};
+
+		typedef std::pair<void*, std::shared_ptr<LaneSubscription>> LaneSubscriptionPair;
+
+		ChannelQueue() : stats_(typeid(tMessage).name()), is_scheduled_(false) {
+		}
+
+		template <typename tList, typename tArg>
+		void invoke(const tList& list, const tArg& arg) {
+			if (!ChannelMetrics::isEnabled()) {
+				for (const auto& pair : list)
+					pair.second(arg);
+
+				return;
+			}
+
+			for (const auto& pair : list) {
+				auto start = MonotonicClock::ticks();
+				pair.second(arg);
+				auto elapsed = MonotonicClock::toDuration(MonotonicClock::ticks() - start);
+
+				stats_.recordHandler(pair.first, elapsed.count());
+			}
 		}
 
 		template <typename tHandler>
@@ -68,18 +290,64 @@ namespace detail {
 			return [handler](const tMessage& message) { (*handler)(message); };
 		}
 
-		typedef std::function<void(const tMessage&)> Handler;
-		typedef std::pair<void*, Handler> HandlerPair;
+		template <typename tHandler>
+		BatchHandler createBatchHandler(tHandler* handler) {
+			return [handler](Span<const tMessage> messages) { (*handler)(messages); };
+		}
 
-		ConcurrentVector<HandlerPair> vector_;
+		template <typename tHandler>
+		Consumer createConsumer(tHandler* handler) {
+			return [handler](Span<tMessage> messages) { (*handler)(messages); };
+		}
+
+		// what ChannelMetrics reports the handler as
+		template <typename tHandler>
+		static std::string nameOf(const char* name) {
+			return name ? std::string(name) : typeName(typeid(tHandler));
+		}
+
+		template <typename tList, typename tHandler>
+		static void removeFrom(tList& list, tHandler* handler) {
+			list.erase(
+				std::remove_if(
+					list.begin(),
+					list.end(),
+					[handler](const typename tList::value_type& pair) {
+						return (handler == pair.first);
+					}
+				),
+				list.end()
+			);
+		}
+
+		ChannelStats stats_;
+
+		ConcurrentSnapshot<HandlerList> handlers_;
+		ConcurrentSnapshot<BatchHandlerList> batch_handlers_;
+		ConcurrentSnapshot<ConsumerList> consumers_;
+
+		Mutex subscriptions_mutex_;
+		std::vector<LaneSubscriptionPair> lane_subscriptions_;
+
+		Mutex posted_mutex_;
+		std::vector<tMessage> posted_;		// filled by post(), from any thread
+		std::vector<tMessage> delivering_;	// the batch currently being dispatched
+		std::atomic<bool> is_scheduled_;
 	};
 }
 
-class Channel {
+class FURRY_API Channel {
 public:
+	// The name is what ChannelMetrics reports the handler as, its (demangled) type if there is none
 	template <typename tEvent, class tHandler>
-	static void add(tHandler* handler) {
-		detail::ChannelQueue<tEvent>::instance().add(handler);
+	static void add(tHandler* handler, const char* name = nullptr) {
+		detail::ChannelQueue<tEvent>::instance().add(handler, name);
+	}
+
+	// Thread-affine handlers, the handler always runs on the given lane (e.g. Lane::main() for GL code)
+	template <typename tEvent, class tHandler>
+	static void add(tHandler* handler, Lane& lane, Delivery delivery = Delivery::Queued, const char* name = nullptr) {
+		detail::ChannelQueue<tEvent>::instance().add(handler, lane, delivery, name);
 	}
 
 	template <typename tEvent, class tHandler>
@@ -87,23 +355,71 @@ public:
 		detail::ChannelQueue<tEvent>::instance().remove(handler);
 	}
 
+	// Batch handlers receive all posted events of a type at once, as Span<const tEvent>
+	template <typename tEvent, class tHandler>
+	static void addBatch(tHandler* handler, const char* name = nullptr) {
+		detail::ChannelQueue<tEvent>::instance().addBatch(handler, name);
+	}
+
+	template <typename tEvent, class tHandler>
+	static void removeBatch(tHandler* handler) {
+		detail::ChannelQueue<tEvent>::instance().removeBatch(handler);
+	}
+
+	// Consumers see posted events last, as a mutable Span<tEvent>, and may take ownership by moving from them
+	template <typename tEvent, class tHandler>
+	static void addConsumer(tHandler* handler, const char* name = nullptr) {
+		detail::ChannelQueue<tEvent>::instance().addConsumer(handler, name);
+	}
+
+	template <typename tEvent, class tHandler>
+	static void removeConsumer(tHandler* handler) {
+		detail::ChannelQueue<tEvent>::instance().removeConsumer(handler);
+	}
+
+	// Immediate delivery, every handler runs on the calling thread
 	template <typename tEvent>
 	static void broadcast(const tEvent& message) {
 		detail::ChannelQueue<tEvent>::instance().broadcast(message);
 	}
+
+	// Deferred delivery, the event is queued and handed out during the next dispatch()
+	// Payloads from the EventArena have to be posted before the dispatch() that follows their
+	// allocation, and are only valid for EventArena::kFrameCount - 1 dispatches after that.
+	template <typename tEvent>
+	static void post(tEvent&& message) {
+		typedef typename std::decay<tEvent>::type Event;
+		detail::ChannelQueue<Event>::instance().post(std::forward<tEvent>(message));
+	}
+
+	// Delivers everything posted so far, one batch per event type. The Engine calls this once per frame
+	// on the main thread; events posted by handlers during dispatch are delivered in the next frame.
+	// Also advances the EventArena, so pooled payloads of older frames get recycled.
+	static void dispatch();
 };
 
 // This is the contract that an object should fulfill for correct usage with a Channel
 // Note that this is not an actual required base class, even though it can be used as one
+// Without a name (a string literal), ChannelMetrics reports subclasses as MessageHandler<tMessage>
 template <typename tMessage>
 class MessageHandler {
 public:
-	MessageHandler() {
-		Channel::add<tMessage>(this);
+	explicit MessageHandler(const char* name = nullptr) : lane_(nullptr), delivery_(Delivery::Queued), name_(name) {
+		Channel::add<tMessage>(this, name_);
 	}
 
-	MessageHandler(const MessageHandler&) {
-		Channel::add<tMessage>(this);
+	// The handler is only ever called on the given lane; it should also be destroyed there
+	explicit MessageHandler(Lane& lane, Delivery delivery = Delivery::Queued, const char* name = nullptr) :
+		lane_(&lane), delivery_(delivery), name_(name)
+	{
+		Channel::add<tMessage>(this, lane, delivery, name_);
+	}
+
+	MessageHandler(const MessageHandler& other) : lane_(other.lane_), delivery_(other.delivery_), name_(other.name_) {
+		if (lane_)
+			Channel::add<tMessage>(this, *lane_, delivery_, name_);
+		else
+			Channel::add<tMessage>(this, name_);
 	}
 
 	~MessageHandler() {
@@ -111,6 +427,55 @@ public:
 	}
 
 	virtual void operator()(const tMessage&) = 0;
+
+private:
+	Lane* lane_;
+	Delivery delivery_;
+	const char* name_;
+};
+
+// Same as MessageHandler, but for consuming posted events batch-wise
+template <typename tMessage>
+class BatchHandler {
+public:
+	explicit BatchHandler(const char* name = nullptr) : name_(name) {
+		Channel::addBatch<tMessage>(this, name_);
+	}
+
+	BatchHandler(const BatchHandler& other) : name_(other.name_) {
+		Channel::addBatch<tMessage>(this, name_);
+	}
+
+	~BatchHandler() {
+		Channel::removeBatch<tMessage>(this);
+	}
+
+	virtual void operator()(Span<const tMessage>) = 0;
+
+private:
+	const char* name_;
+};
+
+// Same as MessageHandler, but takes ownership of posted events
+template <typename tMessage>
+class MessageConsumer {
+public:
+	explicit MessageConsumer(const char* name = nullptr) : name_(name) {
+		Channel::addConsumer<tMessage>(this, name_);
+	}
+
+	MessageConsumer(const MessageConsumer& other) : name_(other.name_) {
+		Channel::addConsumer<tMessage>(this, name_);
+	}
+
+	~MessageConsumer() {
+		Channel::removeConsumer<tMessage>(this);
+	}
+
+	virtual void operator()(Span<tMessage>) = 0;
+
+private:
+	const char* name_;
 };
 
 FURRY_NS_END
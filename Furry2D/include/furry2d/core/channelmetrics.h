@@ -0,0 +1,106 @@
+#ifndef __FURRY_CORE_CHANNELMETRICS_H__
+#define __FURRY_CORE_CHANNELMETRICS_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Optional per-event-type profiling of the Channel
+*
+* While enabled, every broadcast and every handler call is timed. snapshot() returns one
+* entry per event type that has been used since the last reset(). Disabled (the default),
+* the cost is a single relaxed atomic load per broadcast.
+*
+* \ingroup core
+*/
+class FURRY_API ChannelMetrics {
+public:
+	struct Entry {
+		std::string event_;
+		std::uint64_t broadcasts_;
+		double broadcasts_per_second_;
+		size_t handlers_;
+		double total_handler_ms_;
+		double worst_handler_ms_;
+		const void* slowest_handler_;
+		std::string slowest_handler_name_; // as given to Channel::add(), else the type it was registered as
+	};
+
+	static void setEnabled(bool enabled);
+	static bool isEnabled() {
+		return is_enabled_.load(std::memory_order_relaxed);
+	}
+
+	static std::vector<Entry> snapshot(); // sorted by total handler time, most expensive first
+	static void reset();
+
+private:
+	static std::atomic<bool> is_enabled_;
+};
+
+namespace detail {
+	FURRY_API std::string typeName(const std::type_info& type); // demangled where the compiler supports it
+
+	// One object can be registered as message, batch and consumer handler at the same time
+	enum class HandlerKind {
+		Message, Batch, Consumer
+	};
+
+	// The counters of a single event type, owned by its ChannelQueue
+	class FURRY_API ChannelStats {
+	public:
+		explicit ChannelStats(const char* eventName);
+		~ChannelStats();
+
+		ChannelStats(const ChannelStats&) = delete;
+		ChannelStats& operator = (const ChannelStats&) = delete;
+
+		void nameHandler(const void* handler, HandlerKind kind, std::string name);
+		void forgetHandler(const void* handler, HandlerKind kind);
+
+		void recordBroadcast(size_t handlerCount);
+		void recordHandler(const void* handler, std::uint64_t nanoseconds);
+
+		ChannelMetrics::Entry snapshot(double seconds) const;
+		void reset();
+
+	private:
+		const char* event_name_;
+
+		std::atomic<std::uint64_t> broadcasts_;
+		std::atomic<size_t> handlers_;
+		std::atomic<std::uint64_t> total_ns_;
+		std::atomic<std::uint64_t> worst_ns_;
+		std::atomic<const void*> slowest_handler_;
+
+		mutable std::mutex names_mutex_;
+		std::map<std::pair<const void*, HandlerKind>, std::string> handler_names_;
+	};
+}
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef __FURRY_CORE_CONFIGPARSER_H__
+#define __FURRY_CORE_CONFIGPARSER_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <memory>
+#include <string>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Tokenizes a config file in place
+*
+* open() maps the file and splits it into entries whose section, key and value are views into
+* the mapping, so nothing is copied. All entries live in a single allocation sized by the
+* number of lines and are sorted by section and key for binary search lookups.
+*
+* Entries stay valid until the next open()/parse() or the parser's destruction. Same format
+* as ConfigFile; if an entry appears more than once, the last one wins.
+*
+* \ingroup core
+*/
+class FURRY_API ConfigParser {
+public:
+	struct Entry {
+		StringView section_;
+		StringView key_;
+		StringView value_;
+	};
+
+	ConfigParser();
+
+	ConfigParser(const ConfigParser&) = delete;
+	ConfigParser& operator = (const ConfigParser&) = delete;
+
+	bool open(const std::string& filename); // false if the file can't be read
+	void parse(const char* data, size_t size); // data must outlive the entries
+
+	const Entry* find(StringView section, StringView key) const; // nullptr if there is no such entry
+
+	Span<const Entry> entries() const { // sorted, duplicates removed
+		return Span<const Entry>(entries_.get(), size_);
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+private:
+	MappedFile file_;
+	std::unique_ptr<Entry[]> entries_;
+	size_t size_;
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef __FURRY_CORE_CONFIGSTORE_H__
+#define __FURRY_CORE_CONFIGSTORE_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+class ConfigStore;
+
+// how ConfigStore::load reads a file
+enum class ConfigAccess {
+	Mapped,	// parse it in place from a memory mapping, the file must not be truncated meanwhile
+	Copied	// read it into memory first, for files that may be rewritten while they are loaded
+};
+
+/**
+* \brief Handle of a section/entry pair of a ConfigStore
+*
+* Resolve it once (e.g. in System::initialize) and keep it, reading through it is an index
+* into the store. A default constructed key is invalid and always reads the fallback.
+*
+* \ingroup core
+*/
+class FURRY_API ConfigKey {
+	friend class ConfigStore;
+public:
+	ConfigKey() : index_(kInvalid) {}
+
+	bool isValid() const {
+		return index_ != kInvalid;
+	}
+
+	bool operator == (const ConfigKey& other) const {
+		return index_ == other.index_;
+	}
+
+	bool operator != (const ConfigKey& other) const {
+		return index_ != other.index_;
+	}
+
+private:
+	static const std::uint32_t kInvalid = 0xFFFFFFFF;
+
+	explicit ConfigKey(std::uint32_t index) : index_(index) {}
+
+	std::uint32_t index_;
+};
+
+/**
+* \brief Config values that are parsed once, when they are loaded or set
+*
+* Every value is kept as text, integer, floating point number and boolean, so reads through a
+* ConfigKey neither parse, allocate nor throw. Values that are missing or do not convert
+* (e.g. get(key, 0) of "fast") return the fallback.
+*
+* Files are read with ConfigParser, so the format is the one of ConfigFile: "[section]"
+* headers, "entry = value" lines and comments starting with '#' or ';'.
+*
+* Resolving keys, loading and setting are not synchronized with reads.
+*
+* \ingroup core
+*/
+class FURRY_API ConfigStore {
+public:
+	ConfigStore();
+
+	// adds to (and overrides) what is there, false if the file can't be read
+	bool load(const std::string& filename, ConfigAccess access = ConfigAccess::Mapped);
+
+	// Same as load(filename), but keeps the parsed and converted values in a binary image in
+	// cacheFile. As long as modification time, size and hash of the config file match the ones
+	// the image was made from, later loads only copy the values out of the mapped image.
+	bool load(const std::string& filename, const std::string& cacheFile, ConfigAccess access = ConfigAccess::Mapped);
+
+	void parse(const std::string& content);
+
+	// the key is created if it does not exist yet, so it can be resolved before anything is loaded
+	ConfigKey key(StringView section, StringView entry);
+	ConfigKey find(StringView section, StringView entry) const; // invalid if unknown
+
+	bool has(ConfigKey key) const {
+		return key.isValid() && key.index_ < slots_.size() && slots_[key.index_].is_set_;
+	}
+
+	bool get(ConfigKey key, bool fallback) const {
+		return has(key) ? slots_[key.index_].boolean_ : fallback;
+	}
+
+	int get(ConfigKey key, int fallback) const {
+		return has(key) && slots_[key.index_].is_integer_ ? slots_[key.index_].integer_ : fallback;
+	}
+
+	double get(ConfigKey key, double fallback) const {
+		return has(key) && slots_[key.index_].is_number_ ? slots_[key.index_].number_ : fallback;
+	}
+
+	float get(ConfigKey key, float fallback) const {
+		return static_cast<float>(get(key, static_cast<double>(fallback)));
+	}
+
+	const std::string& get(ConfigKey key, const std::string& fallback) const {
+		return has(key) ? slots_[key.index_].text_ : fallback;
+	}
+
+	const char* get(ConfigKey key, const char* fallback) const {
+		return has(key) ? slots_[key.index_].text_.c_str() : fallback;
+	}
+
+	void set(ConfigKey key, StringView value);
+	void clear(); // forgets all values, but keeps the keys
+
+	const std::string& name(ConfigKey key) const; // "section/entry"
+
+	// the keys whose value differs in other, which has to be a (modified) copy of this store
+	std::vector<ConfigKey> changes(const ConfigStore& other) const;
+
+	size_t size() const {
+		return slots_.size();
+	}
+
+private:
+	struct Slot {
+		Slot() : number_(0.0), integer_(0), boolean_(false), is_number_(false), is_integer_(false), is_set_(false) {}
+
+		std::string name_;
+		std::string text_;
+		double number_;
+		int integer_;
+		bool boolean_;
+		bool is_number_;
+		bool is_integer_;
+		bool is_set_;
+	};
+
+	ConfigKey key(StringView name);
+	void add(const ConfigParser& parser);
+
+	struct CacheStamp; // identifies the config file a cache was made from
+
+	static bool stampOf(const std::string& filename, const char* data, size_t size, CacheStamp& stamp);
+	bool loadCache(const std::string& cacheFile, const CacheStamp& stamp);
+	bool saveCache(const std::string& cacheFile, const CacheStamp& stamp, const ConfigParser& parser) const;
+
+	static void convert(Slot& slot, StringView value);
+
+	std::unordered_map<std::string, std::uint32_t> index_; // "section/entry"
+	std::vector<Slot> slots_;
+};
+
+FURRY_NS_END
+
+#endif
@@ -16,63 +16,108 @@
 * ****************************************
 */
 
-#include <furry2d/core/ConfigFile.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 FURRY_NS_BEGIN
 
-class Config : System {
+class FileWatcher;
+
+// posted through the Channel for every value that changed when the config was reloaded
+struct ConfigChanged {
+	ConfigKey key_;
+	std::string name_; // "section/entry"
+};
+
+class FURRY_API Config : public System {
 public:
-	Config() : System("Config"){
-		config_file_ = std::unique_ptr<ConfigFile>(new ConfigFile());
-	}
+	typedef ConcurrentSnapshot<ConfigStore>::ReadGuard ReadGuard;
+
+	Config();
+	virtual ~Config();
+
+	bool load(const std::string &filename);
 
-	virtual ~Config() { }
-
-	bool load(const std::string &filename) {
-		try {
-			config_file_->addConfigFile(filename);
-		}
-		catch (const std::string str) {
-			gLogDebug << "Failed to open config file: " << filename;
-			return false;
-		}
-		return true;
+	// keep a binary image of every loaded file next to it ("<file>.cache"), so later runs skip parsing
+	void enableCache(bool enabled = true) {
+		use_cache_ = enabled;
 	}
 
 	void parseCommandLine(int argc, char* argv[]) {
 		/* TODO */
 	}
 
+	//resolve a variable once, then read it through get(key, ...) as often as needed
+	ConfigKey key(std::string const& section, std::string const& entry);
+
+	template <typename T>
+	T get(ConfigKey key, T value) const {
+		return store_.read()->get(key, value);
+	}
+
+	std::string get(ConfigKey key, const char* value) const {
+		return store_.read()->get(key, value);
+	}
+
 	//get sprecified variable
 	template <typename T>
 	T get(std::string const& section, std::string const& entry) const {
-		try {
-			ConfigFile::Conversion cv = mConfigFile->Value(section, entry);
-			return (T)cv;
-		}
-		catch (const char *str) {
-			gLogDebug << "Failed to find variable: " << section << "/" << entry; 
-			return T();
-		}
+		auto store = store_.read();
+		ConfigKey key = store->find(section, entry);
+
+		if (!store->has(key))
+			gLogDebug << "Failed to find variable: " << section << "/" << entry;
+
+		return store->get(key, T());
 	}
 
 	//get specified variable with default value
 	template <typename T>
 	T get(std::string const& section, std::string const& entry, const T value) const {
-		ConfigFile::Conversion cv = mConfigFile->Value(section, entry, value);
-		return (T)cv;
+		auto store = store_.read();
+		return store->get(store->find(section, entry), value);
 	}
 
 	//spceial case for const char*
 	std::string get(std::string const& section, std::string const& entry, const char *value) const {
-		std::string strValue(value);
-		ConfigFile::Conversion cv = config_file_->Value(section, entry, strValue);
-		return (std::string)cv;
+		auto store = store_.read();
+		return store->get(store->find(section, entry), value);
+	}
+
+	//for reading several values from the same version of the config
+	ReadGuard read() const {
+		return store_.read();
 	}
 
+	// Hot reload: watch the loaded files, re-read all of them if one changes, swap in the new
+	// values at once and post a ConfigChanged for every value that changed. Values changed
+	// through ConfigStore::set in the meantime are lost.
+	void enableHotReload();
+	bool reload();
+
+	virtual bool initialize() override; // starts watching the loaded files on a thread of its own if hot reload is enabled
+	virtual void update() override; // reloads if the loaded files changed, without waiting for changes
+	virtual void shutdown() override;
+
 private:
-	std::unique_ptr<ConfigFile> config_file_;
+	bool loadInto(ConfigStore& store, const std::string& filename, ConfigAccess access) const;
+	void watch(); // runs on watching_ until shutdown(), so no worker of the Engine is blocked
+	void stopWatching();
+
+	ConcurrentSnapshot<ConfigStore> store_;
+	std::mutex writer_mutex_; // guards latest_, store_ is replaced by load() and reload()
+
+	// What store_ was last published from, plus the keys resolved since. Keys are added here
+	// only; snapshots that are shorter read the fallback for them, which is their value anyway.
+	ConfigStore latest_;
+
+	std::vector<std::string> files_;
+	std::unique_ptr<FileWatcher> watcher_;
+	std::atomic<bool> is_watching_;
+	std::thread watching_;
+	bool use_cache_;
 };
 
 FURRY_NS_END
@@ -16,6 +16,7 @@
 * ****************************************
 */
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <map>
@@ -34,8 +35,11 @@ public:
 
 	void setApplication(Application* application); // the Engine will take ownership of the application
 
-	void add(System* system); //note that the Engine will take ownership of the system added
+	//note that the Engine will take ownership of the system added
+	template <typename T>
+	void add(T* system);
 
+	//the system that was added as a T (not a base or derived class of it), nullptr if there is none
 	template <typename T>
 	T* get() const;
 
@@ -47,6 +51,11 @@ public:
 
 	void updateSystem(System* system, bool repeating = false, bool background = false);
 
+	// per-frame cost of every system updated on the main thread (see updateSystem), frame times
+	FrameStats& frameStats() {
+		return frame_stats_;
+	}
+
 	// Signals
 	struct OnStop {};
 
@@ -55,17 +64,21 @@ public:
 
 private:
 	void setApplication(std::unique_ptr<Application>&& application);
-	void add(std::unique_ptr<System>&& system);
+	void add(std::unique_ptr<System>&& system, size_t typeIndex);
 
 	void initializeSystems();
 	void shutdownSystems();
+	void runSystemGraph(bool reversed, const std::function<void(System*)>& action); // reversed: dependents first
 
 	bool initializeDependencies();
 	void shutdownDependencies();
 
-	SystemList systems_;
+	SystemList systems_; // not in the order they were added, remove() moves the last system into the gap
 	SystemMapping system_lookup_;
+	std::vector<std::vector<System*>> system_index_; // by detail::systemTypeIndex, in the order they were added
+	size_t systems_added_;
 	TaskProcessor task_processor_;
+	FrameStats frame_stats_;
 	Config mConfig;
 
 	std::unique_ptr<Application> application_;
@@ -76,17 +89,14 @@ private:
 
 
 template <typename T>
-T* Engine::get() const {
-	T* result = nullptr;
-
-	for (const auto& system : mSystems) {
-		result = dynamic_cast<T*>(system.get());
-
-		if (result)
-			return result;
-	}
+void Engine::add(T* system) {
+	add(std::unique_ptr<System>(system), detail::systemTypeIndex<T>());
+}
 
-	return nullptr;
+template <typename T>
+T* Engine::get() const {
+	size_t index = detail::systemTypeIndex<T>();
+	return index < system_index_.size() && !system_index_[index].empty() ? static_cast<T*>(system_index_[index].front()) : nullptr;
 }
 
 FURRY_NS_END
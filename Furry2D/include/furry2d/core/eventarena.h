@@ -0,0 +1,127 @@
+#ifndef __FURRY_CORE_EVENTARENA_H__
+#define __FURRY_CORE_EVENTARENA_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief String payload that lives in the EventArena (valid until the event has been dispatched)
+*
+* \ingroup core
+*/
+class PooledString {
+public:
+	PooledString() : data_(""), size_(0) {}
+	PooledString(const char* data, size_t size) : data_(data), size_(size) {}
+
+	const char* data() const { return data_; }		// always zero-terminated
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	std::string str() const { // copies, use this to keep the payload beyond dispatch
+		return std::string(data_, size_);
+	}
+
+private:
+	const char* data_;
+	size_t size_;
+};
+
+/**
+* \brief Ring-buffer storage for event payloads, reclaimed in bulk
+*
+* Payloads for posted events (strings, arrays, packets) are bump-allocated from the slot of the
+* current frame instead of the heap. Channel::dispatch() advances the ring once per frame, a slot
+* is reused (and thereby freed) kFrameCount frames later. Payloads have to be posted in the frame
+* they were allocated in. If a frame runs out of space, allocations fall back to the heap and are
+* released together with the slot.
+*
+* allocate() only returns memory of the frame that is current when it returns; advance() waits
+* for allocations that are still in flight in the slot it recycles.
+*
+* \ingroup core
+*/
+class FURRY_API EventArena {
+public:
+	static const size_t kFrameCount = 3;
+	static const size_t kDefaultAlignment = 16;
+
+	explicit EventArena(size_t bytesPerFrame = 1 << 20);
+
+	EventArena(const EventArena&) = delete;
+	EventArena& operator = (const EventArena&) = delete;
+
+	~EventArena();
+
+	static EventArena& instance();
+
+	void* allocate(size_t size, size_t alignment = kDefaultAlignment); // threadsafe, lock-free unless the frame overflows
+
+	template <typename T>
+	Span<T> allocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible<T>::value, "Pooled arrays are never destroyed");
+		return Span<T>(static_cast<T*>(allocate(count * sizeof(T), std::alignment_of<T>::value)), count);
+	}
+
+	template <typename T>
+	Span<const T> copy(const T* data, size_t count) {
+		auto result = allocateArray<T>(count);
+		std::copy(data, data + count, result.begin());
+		return Span<const T>(result.data(), count);
+	}
+
+	PooledString copy(const char* data, size_t size);
+	PooledString copy(const std::string& str) {
+		return copy(str.data(), str.size());
+	}
+
+	void advance(); // starts a new frame and recycles the oldest one; only from the dispatching thread
+
+	size_t overflowCount() const; // heap fallbacks since the last advance
+
+private:
+	struct Frame;
+
+	void* allocateIn(Frame& frame, size_t size, size_t alignment);
+
+	struct Frame {
+		Frame() : offset_(0), in_flight_(0) {}
+
+		std::unique_ptr<char[]> memory_;
+		std::atomic<size_t> offset_;
+		std::atomic<size_t> in_flight_; // allocate() calls that are using this frame
+
+		mutable std::mutex overflow_mutex_;
+		std::vector<std::unique_ptr<char[]>> overflow_;
+	};
+
+	size_t bytes_per_frame_;
+	Frame frames_[kFrameCount];
+	std::atomic<size_t> current_;
+};
+
+FURRY_NS_END
+
+#endif
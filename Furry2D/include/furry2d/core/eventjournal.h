@@ -0,0 +1,160 @@
+#ifndef __FURRY_CORE_EVENTJOURNAL_H__
+#define __FURRY_CORE_EVENTJOURNAL_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Binary journal of Channel traffic
+*
+* File layout: a header (magic, version), followed by records of
+* [uint64 nanoseconds since recording started][uint32 type id][uint32 size][size bytes].
+* Only trivially copyable events can be journaled; type ids are chosen by the user and have
+* to match between recorder and replayer. Ids from kReservedIds upwards belong to the engine.
+*
+* \ingroup core
+*/
+struct FURRY_API EventJournal {
+	static const std::uint32_t kMagic = 0x4A443246; // "F2DJ"
+	static const std::uint32_t kVersion = 1;
+	static const std::uint32_t kMaxRecordSize = 64 * 1024; // larger sizes can only come from a damaged journal
+
+	static const std::uint32_t kReservedIds = 0xFFFF0000;
+	static const std::uint32_t kKeyInput = kReservedIds + 1;
+	static const std::uint32_t kMouseButtonInput = kReservedIds + 2;
+	static const std::uint32_t kMouseMoveInput = kReservedIds + 3;
+	static const std::uint32_t kMouseScrollInput = kReservedIds + 4;
+};
+
+/**
+* \brief Subscribes to chosen event types and writes them to a journal on a background thread
+*
+* \ingroup core
+*/
+class FURRY_API EventRecorder {
+public:
+	explicit EventRecorder(const std::string& filename);
+	~EventRecorder(); // unsubscribes and flushes everything that was recorded
+
+	EventRecorder(const EventRecorder&) = delete;
+	EventRecorder& operator = (const EventRecorder&) = delete;
+
+	template <typename tEvent>
+	void record(std::uint32_t typeId) {
+		static_assert(std::is_trivially_copyable<tEvent>::value, "Only trivially copyable events can be journaled");
+		static_assert(sizeof(tEvent) <= EventJournal::kMaxRecordSize, "Event is too large to be journaled");
+		taps_.emplace_back(new Tap<tEvent>(this, typeId));
+	}
+
+	void recordInput(); // the raw GLFWApplication input events
+
+	void flush(); // hands everything recorded so far to the writer
+
+private:
+	struct TapBase {
+		virtual ~TapBase() {}
+	};
+
+	template <typename tEvent>
+	struct Tap : TapBase {
+		Tap(EventRecorder* owner, std::uint32_t typeId) : owner_(owner), type_id_(typeId) {
+			Channel::add<tEvent>(this);
+		}
+
+		~Tap() {
+			Channel::remove<tEvent>(this);
+		}
+
+		void operator()(const tEvent& message) {
+			owner_->write(type_id_, &message, sizeof(tEvent));
+		}
+
+		EventRecorder* owner_;
+		std::uint32_t type_id_;
+	};
+
+	void write(std::uint32_t typeId, const void* data, std::uint32_t size);
+	void flushLocked();
+
+	std::vector<std::unique_ptr<TapBase>> taps_;
+
+	std::mutex mutex_;
+	std::vector<char> staging_; // records are collected here and shipped to the writer in large chunks
+	std::chrono::steady_clock::time_point start_;
+
+	std::shared_ptr<std::ofstream> file_;
+	std::unique_ptr<Active> writer_;
+};
+
+/**
+* \brief Re-injects a journal through the Channel
+*
+* The replayer broadcasts on the calling thread, so for a headless engine run it from a
+* background task. Records of types that were not registered are skipped.
+*
+* \ingroup core
+*/
+class FURRY_API EventReplayer {
+public:
+	enum class Timing {
+		Original,		// keep the recorded gaps between events
+		AsFastAsPossible
+	};
+
+	explicit EventReplayer(const std::string& filename);
+
+	template <typename tEvent>
+	void replay(std::uint32_t typeId) {
+		static_assert(std::is_trivially_copyable<tEvent>::value, "Only trivially copyable events can be journaled");
+
+		decoders_[typeId] = [](const char* data, std::uint32_t size) {
+			if (size != sizeof(tEvent))
+				return false;
+
+			tEvent message;
+			std::memcpy(&message, data, sizeof(tEvent));
+			Channel::broadcast(message);
+			return true;
+		};
+	}
+
+	void replayInput(); // the raw GLFWApplication input events
+
+	size_t run(Timing timing = Timing::Original); // returns the number of events that were broadcast
+
+private:
+	typedef std::function<bool(const char*, std::uint32_t)> Decoder;
+
+	std::string filename_;
+	std::map<std::uint32_t, Decoder> decoders_;
+};
+
+FURRY_NS_END
+
+#endif
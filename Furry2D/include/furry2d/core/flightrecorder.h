@@ -0,0 +1,77 @@
+#ifndef __FURRY_CORE_FLIGHTRECORDER_H__
+#define __FURRY_CORE_FLIGHTRECORDER_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Keeps the last kCapacity log records, scheduler events and frame markers in memory
+*
+* While enabled, the log frontends hand every message to the recorder right at the call site,
+* also the ones that setLogLevel() keeps away from the sinks. So production can run with only
+* warnings enabled and still have debug context for a crash. (Statements removed by
+* FURRY_LOG_MIN_LEVEL or skipped by a LogModule threshold are not seen.)
+*
+* Recording is lock-free. dump() writes the ring as a binary log (see LogDecoder) using
+* nothing but write(), so it can be called from a signal handler; installCrashHandler()
+* does so on fatal signals and std::terminate, startWatchdog() when frames stop.
+*
+* \ingroup core
+*/
+class FURRY_API FlightRecorder {
+public:
+	static const size_t kCapacity = 4096; // must be a power of two
+	static const size_t kTextCapacity = LogRecord::kTextCapacity;
+	static const size_t kFileCapacity = 48;
+
+	static void setEnabled(bool enabled);
+	static bool isEnabled() {
+		return is_enabled_.load(std::memory_order_relaxed);
+	}
+
+	static void record(LogLevel level, const char* file, int line, const char* text, size_t length, std::uint64_t ticks);
+	static void record(const LogRecord& record);
+	static void recordEvent(const char* text, const char* file, int line); // scheduler and engine events
+	static void markFrame();
+
+	static std::uint64_t frameCount();
+
+	static bool dump(const char* filename); // async-signal-safe
+
+	// dumps to filename on SIGSEGV, SIGABRT, SIGFPE, SIGILL (SIGBUS) and std::terminate, then crashes as before
+	static void installCrashHandler(const std::string& filename);
+
+	// Gives the calling thread an alternate signal stack, so the crash handler can dump even after a
+	// stack overflow. installCrashHandler() does this for its own thread, other threads have to call it.
+	static void installAlternateStack();
+
+	// dumps to the crash handler's file once no frame was marked for timeout
+	static void startWatchdog(std::chrono::milliseconds timeout);
+	static void stopWatchdog();
+
+private:
+	static std::atomic<bool> is_enabled_;
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef __FURRY_CORE_FRAMESTATS_H__
+#define __FURRY_CORE_FRAMESTATS_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+class System;
+
+/**
+* \brief Per-frame cost accounting of the Engine
+*
+* Every frame, the time of each counted phase (the update() of every system that runs on the
+* main thread, an application's update and render, ...) is summed up in its Counter. At the
+* end of a frame the sums are checked against their budgets and folded into the statistics;
+* frame times are kept for the last kHistory frames for percentiles.
+*
+* A frame over the frame budget is logged together with the phase that cost the most in it.
+*
+* \ingroup core
+*/
+class FURRY_API FrameStats {
+public:
+	static const size_t kHistory = 1024; // frames
+
+	class FURRY_API Counter {
+		friend class FrameStats;
+	public:
+		void add(std::uint64_t ticks) { // MonotonicClock ticks, from any thread
+			frame_ticks_.fetch_add(ticks, std::memory_order_relaxed);
+		}
+
+		void setBudget(std::chrono::microseconds budget); // per frame, 0 = none (systems use System::setBudget)
+
+	private:
+		Counter(std::string name, System* system);
+
+		std::string name_;
+		System* system_; // notified when over budget, may be nullptr
+		std::atomic<std::uint64_t> frame_ticks_;
+		std::atomic<std::int64_t> budget_us_;
+
+		// only touched by endFrame() and snapshot() with the mutex held
+		std::uint64_t last_ticks_;
+		std::uint64_t total_ticks_;
+		std::uint64_t max_ticks_;
+		std::uint64_t frames_;
+		std::uint64_t overruns_;
+	};
+
+	// adds the time from construction to destruction to a counter
+	class Scope {
+	public:
+		explicit Scope(Counter* counter) : counter_(counter), start_(MonotonicClock::ticks()) {}
+
+		~Scope() {
+			if (counter_)
+				counter_->add(MonotonicClock::ticks() - start_);
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator = (const Scope&) = delete;
+
+	private:
+		Counter* counter_;
+		std::uint64_t start_;
+	};
+
+	struct Entry {
+		std::string name_;
+		double last_ms_;	// in the last frame
+		double average_ms_;
+		double max_ms_;
+		double budget_ms_;	// 0 if there is none
+		std::uint64_t overruns_;
+	};
+
+	struct Snapshot {
+		std::uint64_t frames_;
+		double p50_ms_;
+		double p95_ms_;
+		double p99_ms_;
+		double max_ms_;				// of the frames in the history
+		std::vector<Entry> entries_; // most expensive on average first
+	};
+
+	FrameStats();
+
+	FrameStats(const FrameStats&) = delete;
+	FrameStats& operator = (const FrameStats&) = delete;
+
+	// the counter of name (created on first use); the pointer stays valid as long as the FrameStats
+	Counter* counter(const std::string& name, System* system = nullptr);
+	void detach(System* system); // before the system goes away, its counter stays
+
+	void endFrame(); // called by the Engine at every frame boundary
+
+	void setFrameBudget(std::chrono::microseconds budget); // 0 = none
+	void setSummaryInterval(std::chrono::seconds interval); // logs a summary this often, 0 = never
+
+	Snapshot snapshot() const;
+	void reset();
+
+private:
+	void logSummary(const Snapshot& snapshot) const;
+
+	mutable std::mutex mutex_;
+	std::vector<std::unique_ptr<Counter>> counters_;
+
+	std::vector<std::uint64_t> frame_ticks_; // ring of the last kHistory frame times
+	std::uint64_t frames_;
+	std::uint64_t frame_start_;
+
+	std::atomic<std::int64_t> frame_budget_us_;
+	std::atomic<std::int64_t> summary_interval_s_;
+	std::uint64_t last_summary_;
+};
+
+FURRY_NS_END
+
+#endif
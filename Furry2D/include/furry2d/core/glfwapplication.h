@@ -26,6 +26,8 @@ FURRY_NS_BEGIN
 class FURRY_API GLFWApplication : public Application {
 private:
 	GLFWwindow* window_;
+	FrameStats::Counter* update_cost_; // resolved on the first update
+	FrameStats::Counter* render_cost_;
 public:
 	struct Args {
 		int &argc;
@@ -37,6 +39,20 @@ public:
 	class MouseEvent;
 	//class MouseMoveEvent;
 	//class MouseScrollEvent;
+
+	/* Raw input, as broadcast through the Channel by the GLFW callbacks (plain data, so it can be journaled) */
+	struct KeyInput {
+		int key_, scancode_, action_, mods_;
+	};
+	struct MouseButtonInput {
+		int button_, action_, mods_;
+	};
+	struct MouseMoveInput {
+		double x_, y_;
+	};
+	struct MouseScrollInput {
+		double x_, y_;
+	};
 	
 	/* Configuration */
 	class Config {
@@ -111,6 +127,8 @@ public:
 	explicit GLFWApplication(const Args &args, const Config &config, std::string name);
 	explicit GLFWApplication(const Args &args, std::string name);
 	explicit GLFWApplication(std::string name);
+
+	virtual ~GLFWApplication();
 	
 	/** No copying and moving allowed*/
 	GLFWApplication(const GLFWApplication&) = delete;
@@ -131,6 +149,12 @@ public:
 
 	void update();
 	void swapBuffers();
+
+	// Handlers
+	void operator()(const KeyInput&);
+	void operator()(const MouseButtonInput&);
+	void operator()(const MouseMoveInput&);
+	void operator()(const MouseScrollInput&);
 protected:
 	/* Input */
 	virtual void keyPressEvent(KeyboardEvent& ev) {}
@@ -149,6 +173,8 @@ protected:
 	// some opnegl-specific methods
 	void clear(float r, float g, float b, float a);
 private:
+	void subscribeInput();
+
 	static GLFWApplication* instance_;
 	static void glfwKeyEvent(GLFWwindow *window, int key, int scancode, int action, int mods);
 	static void glfwMouseEvent(GLFWwindow *window, int button, int action, int mods);
@@ -0,0 +1,64 @@
+#ifndef __FURRY_CORE_LANE_H__
+#define __FURRY_CORE_LANE_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <functional>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Mailbox of a single thread that other threads can hand work to
+*
+* Handlers that are bound to a lane always run on the lane's thread: the main lane is
+* drained by the Engine once per frame, an Active lane on the thread of its Active.
+* Sending is lock-free; the lane has to outlive everything that was sent to it.
+*
+* \ingroup core
+*/
+class FURRY_API Lane {
+public:
+	typedef std::function<void()> Callback;
+
+	Lane();						// drained manually by calling drain() from the owning thread
+	explicit Lane(Active& active);	// drained on the thread of the given Active
+
+	Lane(const Lane&) = delete;
+	Lane& operator = (const Lane&) = delete;
+
+	static Lane& main();
+
+	void send(Callback message);
+	size_t drain(); //returns the number of callbacks that were executed
+
+private:
+	MPSCQueue<Callback> mailbox_;
+	Active* active_;
+	std::atomic<bool> is_drain_scheduled_;
+};
+
+/**
+* \brief How events are handed to a handler that lives on another lane
+*/
+enum class Delivery {
+	Queued,	// every event is delivered
+	Latest	// only the most recent event is delivered, older undelivered ones are dropped (state-type events)
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef __FURRY_CORE_LOGBACKEND_H__
+#define __FURRY_CORE_LOGBACKEND_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+struct LogDescriptor;
+
+/**
+* \brief Fixed-size log record as it travels through the per-thread rings
+*
+* \ingroup core
+*/
+struct LogRecord {
+	static const size_t kTextCapacity = 224;
+
+	std::uint64_t timestamp_;	// MonotonicClock::ticks() at the call site
+	const LogDescriptor* descriptor_; // set for structured records, text_ then holds the encoded arguments
+	const char* file_;			// points to the __FILE__ literal, never copied
+	std::int32_t line_;
+	LogLevel level_;
+	std::uint16_t length_;
+	char text_[kTextCapacity];
+};
+
+/**
+* \brief Single producer/single consumer ring of log records, one per logging thread
+*
+* \ingroup core
+*/
+class FURRY_API LogRing {
+public:
+	static const size_t kCapacity = 1024; // must be a power of two
+
+	LogRing();
+	~LogRing();
+
+	LogRing(const LogRing&) = delete;
+	LogRing& operator = (const LogRing&) = delete;
+
+	bool tryPush(const LogRecord& record); // producer only; never blocks, counts a drop if the ring is full
+
+	template <typename tFunc>
+	size_t consume(tFunc func) { // consumer only
+		std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+		std::uint64_t head = head_.load(std::memory_order_acquire);
+
+		for (std::uint64_t i = tail; i != head; ++i)
+			func(records_[i & (kCapacity - 1)]);
+
+		tail_.store(head, std::memory_order_release);
+		return static_cast<size_t>(head - tail);
+	}
+
+	std::uint64_t takeDropped() {
+		return dropped_.exchange(0, std::memory_order_relaxed);
+	}
+
+	void orphan() { // the owning thread has exited
+		is_orphaned_.store(true, std::memory_order_release);
+	}
+
+	bool isOrphaned() const {
+		return is_orphaned_.load(std::memory_order_acquire);
+	}
+
+private:
+	LogRecord* records_;
+	std::atomic<std::uint64_t> head_;
+	char padding_[64]; // keep producer and consumer indices on different cache lines
+	std::atomic<std::uint64_t> tail_;
+	std::atomic<std::uint64_t> dropped_;
+	std::atomic<bool> is_orphaned_;
+};
+
+/**
+* \brief Single thread that drains the rings of all logging threads into the Logger's sinks
+*
+* \ingroup core
+*/
+class FURRY_API LogBackend {
+public:
+	static LogBackend& instance();
+
+	~LogBackend();
+
+	LogBackend(const LogBackend&) = delete;
+	LogBackend& operator = (const LogBackend&) = delete;
+
+	static void push(const LogRecord& record); // from any thread, lock-free after the thread's first call
+
+	void drain(); // forwards everything queued so far; normally done by the backend thread
+
+private:
+	LogBackend();
+
+	static LogRing& localRing();
+	void registerRing(LogRing* ring);
+	void run();
+	size_t drainOnce();
+
+	std::mutex mutex_; // guards rings_, only taken once per thread and by the backend itself
+	std::vector<LogRing*> rings_;
+
+	std::atomic<bool> is_running_;
+	std::thread thread_;
+};
+
+/**
+* \brief Builds a LogRecord on the stack without touching the heap, pushed on destruction
+*
+* \ingroup core
+*/
+class FURRY_API LogRecordStream {
+public:
+	LogRecordStream(LogLevel level, const char* file, int line);
+	~LogRecordStream();
+
+	LogRecordStream(LogRecordStream&& other);
+
+	LogRecordStream(const LogRecordStream&) = delete;
+	LogRecordStream& operator = (const LogRecordStream&) = delete;
+
+	LogRecordStream& operator << (const char* str);
+	LogRecordStream& operator << (const std::string& str);
+	LogRecordStream& operator << (char c);
+	LogRecordStream& operator << (bool b);
+	LogRecordStream& operator << (short i);
+	LogRecordStream& operator << (unsigned short i);
+	LogRecordStream& operator << (int i);
+	LogRecordStream& operator << (unsigned int i);
+	LogRecordStream& operator << (long i);
+	LogRecordStream& operator << (unsigned long i);
+	LogRecordStream& operator << (long long i);
+	LogRecordStream& operator << (unsigned long long i);
+	LogRecordStream& operator << (float f);
+	LogRecordStream& operator << (double d);
+	LogRecordStream& operator << (const void* p);
+
+	// anything else goes through an ostringstream (and therefore allocates)
+	template <typename T>
+	LogRecordStream& operator << (const T& value) {
+		std::ostringstream ss;
+		ss << value;
+		return *this << ss.str();
+	}
+
+private:
+	void append(const char* data, size_t size);
+
+	LogRecord record_;
+	bool is_active_;
+};
+
+#define gFastLogModuleLevel(module, level) FURRY_LOG_IF(module, level) \
+	::FURRY_NS::LogRecordStream( \
+	::FURRY_NS::LogLevel::level, \
+	__FILE__, \
+	__LINE__ \
+	)
+
+#define gFastLogLevel(level) gFastLogModuleLevel(::FURRY_NS::LogModule::global(), level)
+
+#define gFastLog        gFastLogLevel(EMessage)
+
+#define gFastLogDebug   gFastLogLevel(EDebug)
+#define gFastLogMessage gFastLogLevel(EMessage)
+#define gFastLogError   gFastLogLevel(EError)
+#define gFastLogWarning gFastLogLevel(EWarning)
+#define gFastLogFatal   gFastLogLevel(EFatal)
+
+FURRY_NS_END
+
+#endif
@@ -16,43 +16,144 @@
 * ****************************************
 */
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
 FURRY_NS_BEGIN
 
 class LogSink;
 class LogMessage;
+
+/**
+* \brief What the Logger does with a message while its queue is full
+*
+* \ingroup core
+*/
+enum class LogBackpressure {
+	Drop,	// discard it (the number of dropped messages is reported once the queue drained)
+	Block,	// wait until the queue has room again, for at most 100 ms (and not at all on the sinks' thread), then drop
+	Sample	// keep one out of every sample rate messages, discard the others
+};
+
 /**
 * \brief Logger class
 *
 * \ingroup core
 */
 class FURRY_API Logger {
+	friend class LogBackend; // forwards the records of the ring buffer frontend to sinks_
 public:
+	static const std::chrono::milliseconds kPollInterval; // how often the sinks are polled, see LogSink
+
 	//constructors for local scope.
 	Logger(const std::string& filename);
+	~Logger();
+
 	LogMessage operator()(LogLevel level, const std::string& filename, int line);
 
 	//singleton interface for global scope. 
 	static Logger& instance() {
-		static Logger instance("Furry2d-dev.log");
+		static Logger instance("Furry2d-dev.log", true);
 		return instance;
 	}
 
+	typedef std::vector<LogSink> SinkList;
+
+	// publish a new sink list; messages already on their way keep the list they started with
 	void add(const LogSink& sink);
 	void remove(const LogSink& sink);
 
+	std::shared_ptr<const SinkList> sinks() const {
+		return sinks_.share();
+	}
+
 	void flush(const LogMessage& message) const;
 
+	// bounds the number of messages waiting for the sinks (0 = unbounded); fatal messages are never dropped
+	void setBackpressure(LogBackpressure policy, size_t maxPending, std::uint32_t sampleRate = 16);
+
 private:
-	std::vector<LogSink> sinks_;
+	Logger(const std::string& filename, bool isGlobal);
+
+	void poll(); // runs on poller_ until the Logger is destroyed
+
+	ConcurrentSnapshot<SinkList> sinks_; // immutable snapshots, so readers never lock or copy sinks
+
+	std::atomic<LogBackpressure> policy_;
+	std::atomic<size_t> max_pending_;
+	std::atomic<std::uint32_t> sample_rate_;
+	mutable std::atomic<size_t> pending_;
+	mutable std::atomic<std::uint64_t> dropped_;
+	mutable std::atomic<std::uint64_t> sampled_;
+
 	std::unique_ptr<Active> active_;
+	bool is_global_; // reports what LogSiteLimits suppressed
+
+	// hands a poll of the sinks to active_ every kPollInterval
+	std::mutex poller_mutex_;
+	std::condition_variable poller_wakeup_;
+	bool is_stopping_;
+	std::thread poller_;
 };
 
-#define gLogLevel(level) ::FURRY_NS::Logger::instance()( \
+/**
+* \brief Per call site message budget, see gLogLimited
+*
+* Lives in static storage at the call site. Messages beyond the budget of the current
+* one second window are skipped before their arguments are evaluated; how many were skipped
+* is logged right before the next message that gets through, or by the Logger once the
+* window is over (at the latest when the Logger is destroyed).
+*
+* \ingroup core
+*/
+class FURRY_API LogSiteLimit {
+	friend class Logger;
+public:
+	bool allow(std::uint32_t perSecond, LogLevel level, const char* file, int line);
+
+private:
+	static const int kCountBits = 20;
+
+	// logs the counts of the sites whose window is over, or of all of them
+	static void reportSuppressed(Logger& logger, bool isFinal);
+
+	// all zero-initialized in static storage
+	std::atomic<std::uint64_t> state_; // milliseconds the window started at << kCountBits | messages in it
+	std::atomic<std::uint32_t> suppressed_;
+	std::atomic<bool> is_listed_; // known to reportSuppressed(), which then reads the call site below
+	LogLevel level_;
+	const char* file_;
+	int line_;
+};
+
+#define FURRY_LOG_SITE_LIMIT() \
+	[]() -> ::FURRY_NS::LogSiteLimit& { static ::FURRY_NS::LogSiteLimit limit; return limit; }()
+
+#define gLogModuleLimited(module, level, perSecond) \
+	!(FURRY_LOG_COMPILED(level) && (module).isEnabled(::FURRY_NS::LogLevel::level) && \
+	FURRY_LOG_SITE_LIMIT().allow(perSecond, ::FURRY_NS::LogLevel::level, __FILE__, __LINE__)) ? (void)0 : \
+	::FURRY_NS::detail::LogVoidify() & ::FURRY_NS::Logger::instance()( \
 	::FURRY_NS::LogLevel::level, \
 	__FILE__, \
 	__LINE__ \
 	)
 
+// at most perSecond messages per second from this statement
+#define gLogLimited(level, perSecond) gLogModuleLimited(::FURRY_NS::LogModule::global(), level, perSecond)
+
+#define gLogModuleLevel(module, level) FURRY_LOG_IF(module, level) \
+	::FURRY_NS::Logger::instance()( \
+	::FURRY_NS::LogLevel::level, \
+	__FILE__, \
+	__LINE__ \
+	)
+
+#define gLogLevel(level) gLogModuleLevel(::FURRY_NS::LogModule::global(), level)
+
 #define gLog        gLogLevel(EMessage)
 
 #define gLogDebug   gLogLevel(EDebug)
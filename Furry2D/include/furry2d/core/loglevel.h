@@ -16,7 +16,22 @@
 * ****************************************
 */
 
+#include <atomic>
 #include <ostream>
+#include <string>
+
+/**
+* \brief Compile-time minimum log level (numeric value of LogLevel)
+*
+* Statements below this level are compiled away, including the evaluation of their arguments.
+*/
+#ifndef FURRY_LOG_MIN_LEVEL
+#	ifdef FURRY_DEBUG
+#		define FURRY_LOG_MIN_LEVEL 0	// everything
+#	else
+#		define FURRY_LOG_MIN_LEVEL 1	// no debug output in release builds
+#	endif
+#endif
 
 FURRY_NS_BEGIN
 
@@ -26,12 +41,78 @@ FURRY_NS_BEGIN
 * \ingroup core
 */
 enum class LogLevel {
-	EDebug, EMessage, EWarning, EError, EFatal
+	EDebug = 0, EMessage = 1, EWarning = 2, EError = 3, EFatal = 4
 };
 
 void FURRY_API setLogLevel(LogLevel, bool enabled);
 bool FURRY_API logLevel(LogLevel);
 
+std::ostream& FURRY_API operator << (std::ostream& os, const LogLevel& level); // the prefix used by the text sinks
+
+/**
+* \brief Runtime log threshold for a part of the code base
+*
+* Statements of a module below its threshold are skipped before any argument is evaluated,
+* at the cost of a single relaxed atomic load. Modules are usually defined at namespace scope
+* (see FURRY_LOG_MODULE) and can be adjusted at any time, also by name.
+*
+* \ingroup core
+*/
+class FURRY_API LogModule {
+public:
+	explicit LogModule(const char* name, LogLevel threshold = LogLevel::EDebug);
+	~LogModule();
+
+	LogModule(const LogModule&) = delete;
+	LogModule& operator = (const LogModule&) = delete;
+
+	const char* name() const {
+		return name_;
+	}
+
+	bool isEnabled(LogLevel level) const {
+		return static_cast<int>(level) >= threshold_.load(std::memory_order_relaxed);
+	}
+
+	LogLevel threshold() const {
+		return static_cast<LogLevel>(threshold_.load(std::memory_order_relaxed));
+	}
+
+	void setThreshold(LogLevel threshold) {
+		threshold_.store(static_cast<int>(threshold), std::memory_order_relaxed);
+	}
+
+	static LogModule& global() { // used by the plain gLog* macros
+		return global_;
+	}
+
+	static LogModule* find(const std::string& name); // nullptr if there is no such module
+
+private:
+	const char* name_;
+	std::atomic<int> threshold_;
+
+	static LogModule global_;
+};
+
+#define FURRY_LOG_MODULE(variable, name) ::FURRY_NS::LogModule variable(name)
+
+namespace detail {
+	// lets the log macros be a single expression with a void result (usable in if/else without braces)
+	struct LogVoidify {
+		template <typename T>
+		void operator&(const T&) const {}
+	};
+}
+
+#define FURRY_LOG_COMPILED(level) \
+	(static_cast<int>(::FURRY_NS::LogLevel::level) >= FURRY_LOG_MIN_LEVEL)
+
+// evaluates the stream expression that follows only if the statement is compiled in and enabled in the module
+#define FURRY_LOG_IF(module, level) \
+	!(FURRY_LOG_COMPILED(level) && (module).isEnabled(::FURRY_NS::LogLevel::level)) ? (void)0 : \
+	::FURRY_NS::detail::LogVoidify() &
+
 FURRY_NS_END
 
 #endif
\ No newline at end of file
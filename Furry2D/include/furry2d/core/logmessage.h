@@ -52,6 +52,7 @@ public:
 		LogLevel level_;
 		std::string file_;
 		int line_;
+		std::uint64_t timestamp_; // MonotonicClock::ticks() at the call site, 0 if unknown
 	};
 
 private:
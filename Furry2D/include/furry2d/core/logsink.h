@@ -16,8 +16,45 @@
 * ****************************************
 */
 
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
 FURRY_NS_BEGIN
 
+struct LogRecord;
+
+namespace detail {
+	// true if T can also take the raw records of the ring buffer frontend
+	template <typename T>
+	struct IsBinarySink {
+	private:
+		template <typename U>
+		static auto test(int) -> decltype(std::declval<const U&>()(std::declval<const LogRecord&>()), std::true_type());
+
+		template <typename U>
+		static std::false_type test(...);
+
+	public:
+		static const bool value = decltype(test<T>(0))::value;
+	};
+
+	// true if T wants to be polled while no messages arrive
+	template <typename T>
+	struct IsPolledSink {
+	private:
+		template <typename U>
+		static auto test(int) -> decltype(std::declval<const U&>().poll(), std::true_type());
+
+		template <typename U>
+		static std::false_type test(...);
+
+	public:
+		static const bool value = decltype(test<T>(0))::value;
+	};
+}
+
 /**
 * \brief Log sink
 *
@@ -28,6 +65,13 @@ public:
 	/**
 	The wrapped type T should have:
 	- void operator()(const LogMessage& meta, const std::string& message) const;
+	A binary sink additionally has:
+	- void operator()(const LogRecord& record) const;
+	and receives the records of the ring buffer frontend unformatted.
+	A sink that buffers may have:
+	- void poll() const;
+	which the Logger calls on the sinks' thread every Logger::kPollInterval, e.g. to write out
+	what has been buffered for too long.
 	*/
 	template <typename T>
 	LogSink(T impl) : wrapper_(new Model<T>(std::forward<T>(impl))) {}
@@ -45,27 +89,30 @@ public:
 		const std::string& message
 		) const;
 
-	friend std::ostream &operator << (std::ostream& os, const LogLevel& level);
+	bool isBinary() const;
+	void forward(const LogRecord& record) const; // binary sinks only
+
+	void poll() const;
 
 private:
 	struct Concept {
 		virtual ~Concept() = default;
-		virtual Concept* clone() const = 0;
 
 		virtual void forward(
 			const LogMessage::Meta& meta,
 			const std::string& message
 			) const = 0;
+
+		virtual bool isBinary() const = 0;
+		virtual void forward(const LogRecord& record) const = 0;
+
+		virtual void poll() const = 0;
 	};
 
 	template <typename T>
 	struct Model : Concept {
 		Model(T impl) : impl_(std::forward<T>(impl)) {}
 
-		virtual Concept* clone() const  override {
-			return new Model<T>(impl_);
-		}
-
 		virtual void forward(
 			const LogMessage::Meta& meta,
 			const std::string& message
@@ -73,14 +120,71 @@ private:
 			impl_(meta, message);
 		}
 
+		virtual bool isBinary() const override {
+			return detail::IsBinarySink<T>::value;
+		}
+
+		virtual void forward(const LogRecord& record) const override {
+			forwardRecord(record, std::integral_constant<bool, detail::IsBinarySink<T>::value>());
+		}
+
+		void forwardRecord(const LogRecord& record, std::true_type) const {
+			impl_(record);
+		}
+
+		void forwardRecord(const LogRecord&, std::false_type) const {
+			// text sinks get the record formatted by the backend instead
+		}
+
+		virtual void poll() const override {
+			poll(std::integral_constant<bool, detail::IsPolledSink<T>::value>());
+		}
+
+		void poll(std::true_type) const {
+			impl_.poll();
+		}
+
+		void poll(std::false_type) const {
+		}
+
 		T impl_;
 	};
 
-	std::unique_ptr<const Concept> wrapper_;
+	std::shared_ptr<const Concept> wrapper_; // immutable, so copies share it (and compare equal)
+};
+
+/**
+* \brief Buffering and rotation of the file sink
+*
+* Messages are formatted into a write buffer that is flushed when it is full, when a message
+* of flush_level_ or above arrives, or once flush_interval_ has passed since the last flush
+* (checked with every message and every Logger::kPollInterval). A
+* flush rotates the file once it would exceed max_file_size_ or is older than
+* max_file_age_ (0 disables either): "game.log" becomes "game.1.log" and so on, keeping at
+* most max_files_ files including the current one.
+*
+* \ingroup core
+*/
+struct FURRY_API FileSinkOptions {
+	FileSinkOptions();
+
+	size_t buffer_size_;
+	std::chrono::milliseconds flush_interval_;
+	LogLevel flush_level_;
+
+	std::uint64_t max_file_size_;
+	std::chrono::seconds max_file_age_;
+	size_t max_files_;
 };
 
 LogSink FURRY_API makeConsoleSink();
-LogSink FURRY_API makeFileSink(const std::string& filename);
+LogSink FURRY_API makeFileSink(const std::string& filename, const FileSinkOptions& options = FileSinkOptions());
+LogSink FURRY_API makeBinaryFileSink(const std::string& filename); // read back with LogDecoder
+
+// Appends text lines into a memory-mapped file that grows chunkSize bytes at a time. What was
+// written survives a crash of the process; a file that was closed cleanly ends with a marker line
+// ("--- log closed cleanly ---"), one that was not ends in zero bytes.
+LogSink FURRY_API makeMappedFileSink(const std::string& filename, size_t chunkSize = 4 * 1024 * 1024);
 
 FURRY_NS_END
 
@@ -0,0 +1,126 @@
+#ifndef __FURRY_CORE_PROFILER_H__
+#define __FURRY_CORE_PROFILER_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+* \brief Compile-time switch for the profiling zones
+*
+* With FURRY_PROFILE defined as 0, FURRY_PROFILE_ZONE expands to nothing.
+*/
+#ifndef FURRY_PROFILE
+#	define FURRY_PROFILE 1
+#endif
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Everything about a profiling zone that is known at compile time
+*
+* One static, constant-initialized descriptor exists per FURRY_PROFILE_ZONE, so recording a
+* zone only stores its address.
+*
+* \ingroup core
+*/
+struct ProfileZone {
+	const char* name_;
+	const char* file_;
+	int line_;
+};
+
+/**
+* \brief Records the begin and end of profiling zones and exports them as a Chrome trace
+*
+* While enabled, every thread writes MonotonicClock timestamps into a buffer of its own, which
+* is lock-free after the thread's first zone. Nothing is formatted until writeChromeTrace(),
+* which drains the buffers of all threads into the Trace Event JSON that chrome://tracing and
+* Perfetto (ui.perfetto.dev) open. A full buffer drops zones (never blocks), so export
+* regularly when profiling for longer than a few seconds.
+*
+* While disabled, a zone costs a single relaxed atomic load.
+*
+* \ingroup core
+*/
+class FURRY_API Profiler {
+public:
+	static const size_t kCapacity = 16384; // events per thread, must be a power of two
+
+	static void setEnabled(bool enabled);
+	static bool isEnabled() {
+		return is_enabled_.load(std::memory_order_relaxed);
+	}
+
+	static void setThreadName(const std::string& name); // shown instead of the thread id
+
+	static bool begin(const ProfileZone& zone); // false if the event was dropped
+	static void end();
+
+	// drains everything recorded so far; returns the number of zones written
+	static size_t writeChromeTrace(std::ostream& out);
+	static bool writeChromeTrace(const std::string& filename);
+
+	static void clear(); // drops everything recorded so far
+
+private:
+	static std::atomic<bool> is_enabled_;
+};
+
+/**
+* \brief Records a zone from its construction to its destruction
+*
+* \ingroup core
+*/
+class ProfileScope {
+public:
+	explicit ProfileScope(const ProfileZone& zone) :
+		is_recorded_(Profiler::isEnabled() && Profiler::begin(zone))
+	{
+	}
+
+	~ProfileScope() {
+		if (is_recorded_) // also while disabled in between, every begin needs its end
+			Profiler::end();
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator = (const ProfileScope&) = delete;
+
+private:
+	bool is_recorded_;
+};
+
+#define FURRY_PROFILE_CONCAT_(a, b) a##b
+#define FURRY_PROFILE_CONCAT(a, b) FURRY_PROFILE_CONCAT_(a, b)
+
+#if FURRY_PROFILE
+	// profiles the rest of the enclosing scope, name has to be a string literal
+#	define FURRY_PROFILE_ZONE(name) \
+		static const ::FURRY_NS::ProfileZone FURRY_PROFILE_CONCAT(furryProfileZone, __LINE__) = { \
+			name, __FILE__, __LINE__ \
+		}; \
+		::FURRY_NS::ProfileScope FURRY_PROFILE_CONCAT(furryProfileScope, __LINE__)(FURRY_PROFILE_CONCAT(furryProfileZone, __LINE__))
+#else
+#	define FURRY_PROFILE_ZONE(name) do {} while (0)
+#endif
+
+FURRY_NS_END
+
+#endif
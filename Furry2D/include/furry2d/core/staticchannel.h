@@ -0,0 +1,90 @@
+#ifndef __FURRY_CORE_STATICCHANNEL_H__
+#define __FURRY_CORE_STATICCHANNEL_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+FURRY_NS_BEGIN
+
+namespace detail {
+	template <typename tMessage, typename... tHandlers>
+	struct StaticDispatch;
+
+	template <typename tMessage>
+	struct StaticDispatch<tMessage> {
+		static void call(const tMessage&) {}
+		static void call(Span<const tMessage>) {}
+	};
+
+	template <typename tMessage, typename tHead, typename... tTail>
+	struct StaticDispatch<tMessage, tHead, tTail...> {
+		static void call(const tMessage& message) {
+			tHead()(message);
+			StaticDispatch<tMessage, tTail...>::call(message);
+		}
+
+		// handler by handler instead of message by message, keeps each handler's loop tight
+		static void call(Span<const tMessage> messages) {
+			tHead handler;
+
+			for (const auto& message : messages)
+				handler(message);
+
+			StaticDispatch<tMessage, tTail...>::call(messages);
+		}
+	};
+}
+
+/**
+* \brief Channel with a handler set that is fixed at compile time
+*
+* Every handler is a default constructible type with operator()(const tMessage&). Handlers are
+* called directly in the given order, so there is no registration, no lookup and no indirect call
+* and the compiler is free to inline everything. Use it for hot per-entity/per-contact events;
+* the dynamic Channel stays in charge of subscriptions that change at runtime.
+*
+* Example:
+*	typedef StaticChannel<Contact, PlaySound, ApplyDamage> ContactChannel;
+*	ContactChannel::broadcast(contact);
+*
+* \ingroup core
+*/
+template <typename tMessage, typename... tHandlers>
+class StaticChannel {
+public:
+	static void broadcast(const tMessage& message) {
+		detail::StaticDispatch<tMessage, tHandlers...>::call(message);
+	}
+
+	static void broadcast(Span<const tMessage> messages) {
+		detail::StaticDispatch<tMessage, tHandlers...>::call(messages);
+	}
+};
+
+/**
+* \brief Adapts a free function to the StaticChannel handler contract
+*
+* The function pointer is a template argument, so the call is still direct.
+*/
+template <typename tMessage, void (*tFunction)(const tMessage&)>
+struct FunctionHandler {
+	void operator()(const tMessage& message) const {
+		tFunction(message);
+	}
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef __FURRY_CORE_STRUCTUREDLOG_H__
+#define __FURRY_CORE_STRUCTUREDLOG_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Everything about a structured log statement that is known at compile time
+*
+* One static, constant-initialized descriptor exists per call site (see gLogFormat), its
+* address identifies the call site in binary logs.
+*
+* \ingroup core
+*/
+struct LogDescriptor {
+	const char* format_; // "{}" is replaced by the next argument
+	LogLevel level_;
+	const char* file_;
+	int line_;
+};
+
+namespace detail {
+	// type tags of the encoded arguments
+	enum LogArgumentTag : std::uint8_t {
+		kLogInt = 1,		// int64
+		kLogUInt = 2,		// uint64
+		kLogDouble = 3,		// double
+		kLogBool = 4,		// uint8
+		kLogChar = 5,		// char
+		kLogString = 6,		// uint16 length + bytes
+		kLogPointer = 7		// uint64
+	};
+}
+
+/**
+* \brief Copies the raw bytes of the arguments of a structured log statement into a LogRecord
+*
+* Formatting is left to the backend thread (text sinks) or to LogDecoder (binary sinks).
+*
+* \ingroup core
+*/
+class FURRY_API LogArgumentEncoder {
+public:
+	explicit LogArgumentEncoder(const LogDescriptor& descriptor);
+
+	LogArgumentEncoder(const LogArgumentEncoder&) = delete;
+	LogArgumentEncoder& operator = (const LogArgumentEncoder&) = delete;
+
+	template <typename... tArgs>
+	void operator()(const tArgs&... args) {
+		if (!is_wanted_)
+			return;
+
+		int expand[] = { 0, (encode(args), 0)... };
+		(void)expand;
+
+		push();
+	}
+
+private:
+	void encode(const char* str);
+	void encode(const std::string& str);
+	void encode(char c);
+	void encode(bool b);
+	void encode(short i);
+	void encode(unsigned short i);
+	void encode(int i);
+	void encode(unsigned int i);
+	void encode(long i);
+	void encode(unsigned long i);
+	void encode(long long i);
+	void encode(unsigned long long i);
+	void encode(float f);
+	void encode(double d);
+	void encode(const void* p);
+
+	// anything else is formatted right away (and therefore allocates)
+	template <typename T>
+	void encode(const T& value) {
+		std::ostringstream ss;
+		ss << value;
+		encode(ss.str());
+	}
+
+	void append(std::uint8_t tag, const void* data, size_t size);
+	void encodeString(const char* str, size_t size);
+	void push();
+
+	LogRecord record_;
+	bool is_active_; // for the sinks
+	bool is_wanted_; // by the sinks or the FlightRecorder
+};
+
+/**
+* \brief Formats the encoded arguments of a structured record
+*
+* Missing arguments (e.g. cut off because the record was full) show up as "{?}".
+*/
+std::string FURRY_API formatLogArguments(const char* format, const char* data, size_t size);
+
+/**
+* \brief Turns a log written by a binary sink (see makeBinaryFileSink) back into text
+*
+* \ingroup core
+*/
+class FURRY_API LogDecoder {
+public:
+	static const std::uint32_t kMagic = 0x4C443246; // "F2DL"
+	static const std::uint32_t kVersion = 1;
+
+	// entry kinds of the file format, timestamps are nanoseconds since the Unix epoch
+	enum Entry : std::uint8_t {
+		kDescriptor = 1,	// uint64 id, uint8 level, uint32 line, uint16 + file, uint16 + format
+		kRecord = 2,		// uint64 id, uint64 timestamp, uint16 + encoded arguments
+		kText = 3			// uint64 timestamp, uint8 level, uint32 line, uint16 + file, uint32 + message
+	};
+
+	explicit LogDecoder(std::istream& in);
+
+	size_t decode(std::ostream& out); // returns the number of messages written; throws if the input is no binary log
+
+private:
+	std::istream& in_;
+};
+
+#define gLogFormatModule(module, level, format, ...) \
+	do { \
+		if (FURRY_LOG_COMPILED(level) && (module).isEnabled(::FURRY_NS::LogLevel::level)) { \
+			static const ::FURRY_NS::LogDescriptor furryLogDescriptor = { \
+				format, ::FURRY_NS::LogLevel::level, __FILE__, __LINE__ \
+			}; \
+			::FURRY_NS::LogArgumentEncoder{ furryLogDescriptor }(__VA_ARGS__); \
+		} \
+	} while (0)
+
+#define gLogFormat(level, format, ...) \
+	gLogFormatModule(::FURRY_NS::LogModule::global(), level, format, __VA_ARGS__)
+
+FURRY_NS_END
+
+#endif
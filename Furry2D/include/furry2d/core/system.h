@@ -16,16 +16,32 @@
 * ****************************************
 */
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 FURRY_NS_BEGIN
 
 class Engine;
 
+namespace detail {
+	size_t FURRY_API nextSystemTypeIndex();
+
+	// dense index per system type, assigned on first use; the Engine's registry is an array of these
+	template <typename T>
+	size_t systemTypeIndex() {
+		static const size_t index = nextSystemTypeIndex();
+		return index;
+	}
+}
+
 // Abstract 'system' (aka module)
 class FURRY_API System {
 public:
 	friend class Engine;
 
 	System(std::string name);
+	virtual ~System() {}
 
 	System(const System&) = delete;
 	System& operator = (const System&) = delete;
@@ -38,12 +54,45 @@ public:
 		return name_;
 	}
 
+	// names of the systems that are initialized before and shut down after this one
+	const std::vector<std::string>& getDependencies() const {
+		return dependencies_;
+	}
+
+	bool isMainThreadOnly() const {
+		return is_main_thread_only_;
+	}
+
+	// time update() may take per frame, 0 = unlimited
+	std::chrono::microseconds getBudget() const {
+		return budget_;
+	}
+
+	// called at the end of a frame in which update() took longer than the budget; logs by default
+	virtual void budgetExceeded(std::chrono::microseconds cost);
+
 protected:
 	void setName(std::string name);
 
+	// Systems without dependencies between them are initialized and shut down concurrently,
+	// unless initialize()/shutdown() have to be called on the main thread
+	void addDependency(std::string systemName);
+	void setMainThreadOnly(bool enabled);
+
+	void setBudget(std::chrono::microseconds budget);
+
 	Channel channel_;
 	Engine* engine_;
 	std::string name_;
+
+private:
+	std::vector<std::string> dependencies_;
+	bool is_main_thread_only_;
+	std::chrono::microseconds budget_;
+
+	size_t type_index_; // set by Engine::add
+	size_t position_; // in Engine::systems_
+	size_t order_; // how many systems were added to the Engine before this one
 };
 
 FURRY_NS_END
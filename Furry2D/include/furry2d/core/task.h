@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <string>
 
 FURRY_NS_BEGIN
 
@@ -28,13 +29,15 @@ namespace detail {
 	struct FURRY_API WrappedTask {
 	public:
 		explicit WrappedTask();
-		explicit WrappedTask(Task t, bool repeating, bool background);
+		explicit WrappedTask(Task t, bool repeating, bool background, std::string label = std::string());
 
 		void operator()() const;
 
 		bool isRepeating() const;
 		bool isBackground() const;
 
+		const char* name() const; // the label given when the task was added, or else the (compiler specific) name of the wrapped callable's type
+
 		friend class TaskProcessor;
 
 	private:
@@ -42,6 +45,7 @@ namespace detail {
 		void setBackground(bool enabled); // modifying the background status does not change the execution style immediately - it only affects future executions of this task
 
 		Task unwrapped_task_;
+		std::string label_;
 		uint32_t is_repeating_ : 1;
 		uint32_t is_background_ : 1;
 	};
@@ -51,7 +55,8 @@ namespace detail {
 detail::WrappedTask FURRY_API make_wrapped(
 	Task task,
 	bool repeating = false,
-	bool isBackground = false
+	bool isBackground = false,
+	std::string label = std::string()
 );
 
 FURRY_NS_END
@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <thread>
+#include <vector>
 
 FURRY_NS_BEGIN
 
@@ -28,7 +29,7 @@ private:
 public:
 	TaskProcessor(size_t numWorkers = 0); //use 0 for autodetect
 
-	void addWork(Task t, bool repeating = false, bool background = false);
+	void addWork(Task t, bool repeating = false, bool background = false, std::string label = std::string()); // the label names the task in the flight recorder
 
 	// explicit aliases for various types of work
 	void addRepeatingWork(Task t, bool background = false);
@@ -38,6 +39,20 @@ public:
 	void start();
 	void stop();
 
+	// a task of runGraph, run after all tasks it depends on (indices into the same list)
+	struct GraphTask {
+		GraphTask() : is_main_thread_only_(false) {}
+
+		Task task_;
+		std::vector<size_t> dependencies_;
+		bool is_main_thread_only_; // run on the thread that called runGraph
+	};
+
+	// Runs every task once, in dependency order, on the calling thread and up to numWorkers extra
+	// threads; independent of start()/stop(). Returns false without running anything if the
+	// dependencies are cyclic or refer to tasks that do not exist.
+	bool runGraph(const std::vector<GraphTask>& tasks);
+
 private:
 	void addWork(detail::WrappedTask t);	//places the task in the appropriate queue
 	void execute(detail::WrappedTask t);
@@ -34,7 +34,14 @@ using std::endl;
 //// Util classes 
 #include <furry2d/util/concurrentqueue.h>
 #include <furry2d/util/concurrentvector.h>
+#include <furry2d/util/concurrentsnapshot.h>
+#include <furry2d/util/span.h>
+#include <furry2d/util/stringview.h>
+#include <furry2d/util/mappedfile.h>
+#include <furry2d/util/filewatcher.h>
+#include <furry2d/util/mpscqueue.h>
 #include <furry2d/util/active.h>
+#include <furry2d/util/clock.h>
 #include <furry2d/util/timer.h>
 // Basic subset of core classes follows here 
 #include <furry2d/core/version.h>
@@ -43,15 +50,29 @@ using std::endl;
 #include <furry2d/core/logger.h>
 #include <furry2d/core/logmessage.h>
 #include <furry2d/core/logsink.h>
+#include <furry2d/core/logbackend.h>
+#include <furry2d/core/structuredlog.h>
+#include <furry2d/core/flightrecorder.h>
+// Profiling
+#include <furry2d/core/profiler.h>
 
 #include <GL/gl3w.h>
 #include <GLFW/glfw3.h>
 
 // System stuff
+#include <furry2d/core/lane.h>
+#include <furry2d/core/eventarena.h>
+#include <furry2d/core/channelmetrics.h>
 #include <furry2d/core/channel.h>
+#include <furry2d/core/staticchannel.h>
 #include <furry2d/core/system.h>
+#include <furry2d/core/framestats.h>
 #include <furry2d/core/application.h>
 #include <furry2d/core/glfwapplication.h>
+#include <furry2d/core/eventjournal.h>
+#include <furry2d/core/configfile.h>
+#include <furry2d/core/configparser.h>
+#include <furry2d/core/configstore.h>
 #include <furry2d/core/configsystem.h>
 #include <furry2d/core/task.h>
 #include <furry2d/core/taskprocessor.h>
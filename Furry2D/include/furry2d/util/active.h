@@ -41,6 +41,8 @@ public:
 	static std::unique_ptr<Active> create();
 	void send(Callback message);
 
+	bool isCurrentThread() const; // true while running a message
+
 private:
 	void run();
 
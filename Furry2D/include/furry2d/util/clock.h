@@ -0,0 +1,57 @@
+#ifndef __FURRY_UTIL_CLOCK_H__
+#define __FURRY_UTIL_CLOCK_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <chrono>
+#include <cstdint>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Cheap monotonic timestamps that can be converted to wall-clock time
+*
+* ticks() reads the raw counter (CLOCK_MONOTONIC_RAW, QueryPerformanceCounter on Windows)
+* and is meant to be called where an event happens; conversion to durations or wall-clock
+* time is left to whoever formats the timestamp. The clock is calibrated against the system
+* clock once, so its time points count from the Unix epoch and timestamps of the Timer, the
+* logger and the profiler line up.
+*
+* \ingroup util
+*/
+class FURRY_API MonotonicClock {
+public:
+	typedef std::chrono::nanoseconds duration;
+	typedef duration::rep rep;
+	typedef duration::period period;
+	typedef std::chrono::time_point<MonotonicClock> time_point;
+	static const bool is_steady = true;
+
+	static time_point now() {
+		return time_point(sinceEpoch(ticks()));
+	}
+
+	static std::uint64_t ticks();
+	static std::uint64_t frequency(); // ticks per second
+
+	static duration toDuration(std::uint64_t ticks);	// for differences of two ticks() values
+	static duration sinceEpoch(std::uint64_t ticks);	// calibrated to the Unix epoch
+	static std::chrono::system_clock::time_point toSystemTime(std::uint64_t ticks);
+};
+
+FURRY_NS_END
+
+#endif
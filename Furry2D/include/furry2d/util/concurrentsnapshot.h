@@ -0,0 +1,179 @@
+#ifndef __FURRY_UTIL_CONCURRENTSNAPSHOT_H__
+#define __FURRY_UTIL_CONCURRENTSNAPSHOT_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Read-copy-update container for data that is read very often and written rarely
+*
+* Readers get the current immutable snapshot without taking a lock or copying anything.
+* Writers copy the current snapshot, modify the copy and publish it atomically; the old
+* snapshot is retired and freed as soon as its own readers are gone, independent of readers
+* of newer snapshots.
+*
+* \ingroup util
+*/
+template <typename T>
+class ConcurrentSnapshot {
+private:
+	typedef std::mutex Mutex;
+	typedef std::lock_guard<Mutex> ScopedLock;
+	typedef std::unique_lock<Mutex> UniqueLock;
+
+	struct Node {
+		explicit Node(std::shared_ptr<const T> value) : value_(std::move(value)), readers_(0) {}
+		std::shared_ptr<const T> value_;
+		mutable std::atomic<std::uint32_t> readers_;
+	};
+
+public:
+	/// Keeps the snapshot that was current at construction alive until destroyed
+	class ReadGuard {
+		friend class ConcurrentSnapshot;
+	public:
+		explicit ReadGuard(const ConcurrentSnapshot* owner) : owner_(owner) {
+			// entering_ covers the gap between loading the node and counting on it, see reclaim()
+			owner_->entering_.fetch_add(1);
+			node_ = owner_->current_.load();
+			node_->readers_.fetch_add(1);
+			owner_->entering_.fetch_sub(1);
+		}
+
+		ReadGuard(ReadGuard&& other) : owner_(other.owner_), node_(other.node_) {
+			other.owner_ = nullptr;
+		}
+
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator = (const ReadGuard&) = delete;
+
+		~ReadGuard() {
+			if (owner_)
+				owner_->release(node_);
+		}
+
+		const T& operator*() const {
+			return *node_->value_;
+		}
+
+		const T* operator->() const {
+			return node_->value_.get();
+		}
+
+	private:
+		const ConcurrentSnapshot* owner_;
+		const Node* node_;
+	};
+
+	ConcurrentSnapshot() : current_(new Node(std::make_shared<T>())), entering_(0), has_retired_(false) {}
+
+	ConcurrentSnapshot(const ConcurrentSnapshot&) = delete;
+	ConcurrentSnapshot& operator = (const ConcurrentSnapshot&) = delete;
+
+	~ConcurrentSnapshot() {
+		for (auto node : retired_)
+			delete node;
+
+		delete current_.load();
+	}
+
+	/// Lock-free and allocation-free access to the current snapshot
+	ReadGuard read() const {
+		return ReadGuard(this);
+	}
+
+	/// Shared ownership of the current snapshot, for readers that have to keep it beyond the current scope
+	std::shared_ptr<const T> share() const {
+		ReadGuard guard(this);
+		return guard.node_->value_;
+	}
+
+	/// Copies the current snapshot, applies mutator(T&) to the copy and publishes the result
+	template <typename tMutator>
+	void update(tMutator mutator) {
+		ScopedLock lock(writer_mutex_);
+
+		std::shared_ptr<T> copy = std::make_shared<T>(*current_.load()->value_);
+		mutator(*copy);
+
+		replace(std::move(copy));
+	}
+
+	/// Publishes value without copying the current snapshot, e.g. one built from share() beforehand
+	/// (writers that do so have to be serialized by the caller, or updates in between are lost)
+	void publish(T value) {
+		ScopedLock lock(writer_mutex_);
+		replace(std::make_shared<const T>(std::move(value)));
+	}
+
+private:
+	// only called with writer_mutex_ held
+	void replace(std::shared_ptr<const T> value) {
+		const Node* old = current_.load();
+		current_.store(new Node(std::move(value)));
+
+		retired_.push_back(old);
+		has_retired_.store(true);
+
+		reclaim();
+	}
+
+	// only called with writer_mutex_ held
+	void reclaim() const {
+		// A reader that is not entering anymore has either counted itself on its node or will
+		// load a node that is not retired yet. So retired nodes without readers can go.
+		if (entering_.load() != 0)
+			return;
+
+		auto end = std::remove_if(retired_.begin(), retired_.end(), [](const Node* node) {
+			if (node->readers_.load() != 0)
+				return false;
+
+			delete node;
+			return true;
+		});
+
+		retired_.erase(end, retired_.end());
+		has_retired_.store(!retired_.empty());
+	}
+
+	void release(const Node* node) const {
+		// the last reader of a node cleans up after writers that could not, but never waits for them
+		if (node->readers_.fetch_sub(1) == 1 && has_retired_.load()) {
+			UniqueLock lock(writer_mutex_, std::try_to_lock);
+
+			if (lock.owns_lock())
+				reclaim();
+		}
+	}
+
+	std::atomic<const Node*> current_;
+	mutable std::atomic<std::uint32_t> entering_; // readers between loading current_ and counting on it
+	mutable std::atomic<bool> has_retired_;
+	mutable std::vector<const Node*> retired_;
+	mutable Mutex writer_mutex_;
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef __FURRY_UTIL_FILEWATCHER_H__
+#define __FURRY_UTIL_FILEWATCHER_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Reports when watched files were written or replaced
+*
+* Uses inotify on Linux (watching the directories, so files replaced by a rename are noticed
+* as well) and compares modification times on other platforms. wait() is meant to be called
+* over and over from a background thread; add() may be called from any thread.
+*
+* \ingroup util
+*/
+class FURRY_API FileWatcher {
+public:
+	FileWatcher();
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator = (const FileWatcher&) = delete;
+
+	bool add(const std::string& filename);
+
+	// blocks for at most timeout, returns the watched files that changed (as passed to add)
+	std::vector<std::string> wait(std::chrono::milliseconds timeout);
+
+private:
+	struct Watch {
+		std::string filename_;
+		std::string name_;			// without the directory
+		int descriptor_;			// of the directory (inotify)
+		std::int64_t modified_;		// when polling
+		std::int64_t size_;
+	};
+
+	typedef std::mutex Mutex;
+	typedef std::lock_guard<Mutex> ScopedLock;
+
+	Mutex mutex_;
+	std::vector<Watch> watches_;
+	int fd_; // inotify instance, -1 when polling
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef __FURRY_UTIL_MAPPEDFILE_H__
+#define __FURRY_UTIL_MAPPEDFILE_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <string>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Read-only memory mapping of a whole file
+*
+* \ingroup util
+*/
+class FURRY_API MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	bool open(const std::string& filename); // false if the file can't be opened or mapped
+	void close();
+
+	bool isOpen() const {
+		return is_open_;
+	}
+
+	const char* data() const {
+		return data_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+private:
+	const char* data_;
+	size_t size_;
+	bool is_open_;
+
+#ifdef FURRY_PLATFORM_WINDOWS
+	void* file_;
+	void* mapping_;
+#endif
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef __FURRY_UTIL_MPSCQUEUE_H__
+#define __FURRY_UTIL_MPSCQUEUE_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <atomic>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Lock-free queue for many producers and a single consumer
+* (see: http://www.1024cores.net/home/lock-free-algorithms/queues/non-intrusive-mpsc-node-based-queue)
+*
+* push() may be called from any thread, try_pop() only from the owning thread.
+*
+* \ingroup util
+*/
+template <typename T>
+class MPSCQueue {
+private:
+	struct Node {
+		Node() : next_(nullptr) {}
+		explicit Node(T value) : next_(nullptr), value_(std::move(value)) {}
+
+		std::atomic<Node*> next_;
+		T value_;
+	};
+
+public:
+	MPSCQueue() {
+		Node* stub = new Node;
+		head_.store(stub);
+		tail_ = stub;
+	}
+
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+	~MPSCQueue() {
+		while (tail_) {
+			Node* next = tail_->next_.load();
+			delete tail_;
+			tail_ = next;
+		}
+	}
+
+	void push(T element) {
+		Node* node = new Node(std::move(element));
+		Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->next_.store(node, std::memory_order_release);
+	}
+
+	bool try_pop(T& result) {
+		Node* tail = tail_;
+		Node* next = tail->next_.load(std::memory_order_acquire);
+
+		if (!next)
+			return false;
+
+		result = std::move(next->value_);
+		tail_ = next; // next becomes the new stub
+		delete tail;
+
+		return true;
+	}
+
+private:
+	std::atomic<Node*> head_;	// producers push here
+	Node* tail_;				// consumer side, always points to the current stub
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef __FURRY_UTIL_SPAN_H__
+#define __FURRY_UTIL_SPAN_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <cstddef>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Non-owning view of a contiguous sequence of elements (similiar to std::span)
+*
+* \ingroup util
+*/
+template <typename T>
+class Span {
+public:
+	typedef T* iterator;
+
+	Span() : data_(nullptr), size_(0) {}
+	Span(T* data, size_t size) : data_(data), size_(size) {}
+
+	T* data() const { return data_; }
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	T& operator[](size_t index) const {
+		return data_[index];
+	}
+
+	iterator begin() const { return data_; }
+	iterator end() const { return data_ + size_; }
+
+private:
+	T* data_;
+	size_t size_;
+};
+
+FURRY_NS_END
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef __FURRY_UTIL_STRINGVIEW_H__
+#define __FURRY_UTIL_STRINGVIEW_H__
+
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+FURRY_NS_BEGIN
+
+/**
+* \brief Non-owning view of a sequence of characters (similiar to std::string_view)
+*
+* \ingroup util
+*/
+class StringView {
+public:
+	StringView() : data_(nullptr), size_(0) {}
+	StringView(const char* data, size_t size) : data_(data), size_(size) {}
+	StringView(const char* str) : data_(str), size_(std::strlen(str)) {}
+	StringView(const std::string& str) : data_(str.data()), size_(str.size()) {}
+
+	const char* data() const { return data_; }
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	const char& operator[](size_t index) const {
+		return data_[index];
+	}
+
+	const char* begin() const { return data_; }
+	const char* end() const { return data_ + size_; }
+
+	std::string str() const {
+		return std::string(data_, size_);
+	}
+
+	int compare(const StringView& other) const {
+		int result = size_ && other.size_ ? std::memcmp(data_, other.data_, size_ < other.size_ ? size_ : other.size_) : 0;
+		return result != 0 ? result : size_ < other.size_ ? -1 : size_ > other.size_ ? 1 : 0;
+	}
+
+	bool operator == (const StringView& other) const { return size_ == other.size_ && compare(other) == 0; }
+	bool operator != (const StringView& other) const { return !(*this == other); }
+	bool operator < (const StringView& other) const { return compare(other) < 0; }
+
+private:
+	const char* data_;
+	size_t size_;
+};
+
+FURRY_NS_END
+
+#endif
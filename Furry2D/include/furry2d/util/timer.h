@@ -16,7 +16,7 @@ FURRY_NS_BEGIN
 * \ingroup util
 */
 class Timer {
-	typedef std::chrono::high_resolution_clock HighResolutionClock;
+	typedef MonotonicClock Clock;
 	typedef std::chrono::milliseconds Milliseconds;
 public:
 	explicit Timer(bool run = false) {
@@ -24,17 +24,17 @@ public:
 			reset();
 	}
 	void reset() {
-		start_ = HighResolutionClock::now();
+		start_ = Clock::now();
 	}
 	Milliseconds elapsed() const {
-		return std::chrono::duration_cast<Milliseconds>(HighResolutionClock::now() - start_);
+		return std::chrono::duration_cast<Milliseconds>(Clock::now() - start_);
 	}
 	template <typename T, typename Traits>
 	friend std::basic_ostream<T, Traits>& operator<<(std::basic_ostream<T, Traits>& out, const Timer& timer) {
-		return out << timer.Elapsed().count();
+		return out << timer.elapsed().count();
 	}
 private:
-	HighResolutionClock::time_point start_;
+	Clock::time_point start_;
 };
 
 FURRY_NS_END
@@ -0,0 +1,46 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+FURRY_NS_BEGIN
+
+namespace {
+	typedef ConcurrentVector<detail::PostedQueue*> PostedQueueList;
+
+	PostedQueueList& scheduledQueues() {
+		static PostedQueueList queues;
+		return queues;
+	}
+}
+
+namespace detail {
+	void schedulePosted(PostedQueue* queue) {
+		scheduledQueues().push_back(queue);
+	}
+}
+
+void Channel::dispatch() {
+	// allocations from now on belong to the next frame
+	EventArena::instance().advance();
+
+	PostedQueueList localQueues;
+	scheduledQueues().swap(localQueues);
+
+	for (auto queue : localQueues.getInternalsUnsafe())
+		queue->dispatchPosted();
+}
+
+FURRY_NS_END
@@ -0,0 +1,173 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <chrono>
+#include <cstdlib>
+
+#ifdef FURRY_COMPILER_GCC
+#	include <cxxabi.h>
+#endif
+
+FURRY_NS_BEGIN
+
+namespace {
+	typedef std::chrono::steady_clock Clock;
+
+	struct Registry {
+		Registry() : since_(Clock::now()) {}
+
+		std::mutex mutex_;
+		std::vector<detail::ChannelStats*> stats_;
+		Clock::time_point since_;
+	};
+
+	Registry& registry() {
+		static Registry instance;
+		return instance;
+	}
+}
+
+std::atomic<bool> ChannelMetrics::is_enabled_(false);
+
+void ChannelMetrics::setEnabled(bool enabled) {
+	if (enabled && !is_enabled_.load())
+		reset(); // rates are measured from the moment profiling was switched on
+
+	is_enabled_.store(enabled);
+}
+
+std::vector<ChannelMetrics::Entry> ChannelMetrics::snapshot() {
+	auto& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex_);
+
+	double seconds = std::chrono::duration<double>(Clock::now() - reg.since_).count();
+
+	std::vector<Entry> result;
+	for (auto stats : reg.stats_) {
+		auto entry = stats->snapshot(seconds);
+
+		if (entry.broadcasts_ > 0)
+			result.push_back(std::move(entry));
+	}
+
+	std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) {
+		return a.total_handler_ms_ > b.total_handler_ms_;
+	});
+
+	return result;
+}
+
+void ChannelMetrics::reset() {
+	auto& reg = registry();
+	std::lock_guard<std::mutex> lock(reg.mutex_);
+
+	for (auto stats : reg.stats_)
+		stats->reset();
+
+	reg.since_ = Clock::now();
+}
+
+namespace detail {
+	std::string typeName(const std::type_info& type) {
+#ifdef FURRY_COMPILER_GCC
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+		if (demangled) {
+			std::string name(demangled);
+			std::free(demangled);
+			return name;
+		}
+#endif
+		return type.name();
+	}
+
+	ChannelStats::ChannelStats(const char* eventName) :
+		event_name_(eventName),
+		broadcasts_(0),
+		handlers_(0),
+		total_ns_(0),
+		worst_ns_(0),
+		slowest_handler_(nullptr)
+	{
+		auto& reg = registry();
+		std::lock_guard<std::mutex> lock(reg.mutex_);
+		reg.stats_.push_back(this);
+	}
+
+	ChannelStats::~ChannelStats() {
+		auto& reg = registry();
+		std::lock_guard<std::mutex> lock(reg.mutex_);
+		reg.stats_.erase(std::remove(reg.stats_.begin(), reg.stats_.end(), this), reg.stats_.end());
+	}
+
+	void ChannelStats::nameHandler(const void* handler, HandlerKind kind, std::string name) {
+		std::lock_guard<std::mutex> lock(names_mutex_);
+		handler_names_[std::make_pair(handler, kind)] = std::move(name);
+	}
+
+	void ChannelStats::forgetHandler(const void* handler, HandlerKind kind) {
+		std::lock_guard<std::mutex> lock(names_mutex_);
+		handler_names_.erase(std::make_pair(handler, kind));
+	}
+
+	void ChannelStats::recordBroadcast(size_t handlerCount) {
+		broadcasts_.fetch_add(1, std::memory_order_relaxed);
+		handlers_.store(handlerCount, std::memory_order_relaxed);
+	}
+
+	void ChannelStats::recordHandler(const void* handler, std::uint64_t nanoseconds) {
+		total_ns_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+		auto worst = worst_ns_.load(std::memory_order_relaxed);
+		while (nanoseconds > worst) {
+			if (worst_ns_.compare_exchange_weak(worst, nanoseconds, std::memory_order_relaxed)) {
+				slowest_handler_.store(handler, std::memory_order_relaxed); // may lag behind worst_ns_ under contention
+				break;
+			}
+		}
+	}
+
+	ChannelMetrics::Entry ChannelStats::snapshot(double seconds) const {
+		ChannelMetrics::Entry entry;
+
+		entry.event_ = event_name_;
+		entry.broadcasts_ = broadcasts_.load();
+		entry.broadcasts_per_second_ = (seconds > 0.0) ? entry.broadcasts_ / seconds : 0.0;
+		entry.handlers_ = handlers_.load();
+		entry.total_handler_ms_ = total_ns_.load() / 1e6;
+		entry.worst_handler_ms_ = worst_ns_.load() / 1e6;
+		entry.slowest_handler_ = slowest_handler_.load();
+
+		std::lock_guard<std::mutex> lock(names_mutex_);
+		// all kinds of one object are the same handler, so any of their names will do
+		auto it = handler_names_.lower_bound(std::make_pair(entry.slowest_handler_, HandlerKind::Message));
+
+		if (it != handler_names_.end() && it->first.first == entry.slowest_handler_)
+			entry.slowest_handler_name_ = it->second;
+
+		return entry;
+	}
+
+	void ChannelStats::reset() {
+		broadcasts_.store(0);
+		total_ns_.store(0);
+		worst_ns_.store(0);
+		slowest_handler_.store(nullptr);
+	}
+}
+
+FURRY_NS_END
@@ -0,0 +1,115 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+FURRY_NS_BEGIN
+
+namespace {
+	bool isSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	StringView trimmed(const char* begin, const char* end) {
+		while (begin < end && isSpace(*begin))
+			++begin;
+		while (end > begin && isSpace(end[-1]))
+			--end;
+
+		return StringView(begin, end - begin);
+	}
+
+	int compare(const ConfigParser::Entry& lhs, StringView section, StringView key) {
+		int result = lhs.section_.compare(section);
+		return result != 0 ? result : lhs.key_.compare(key);
+	}
+}
+
+ConfigParser::ConfigParser() : size_(0) {
+}
+
+bool ConfigParser::open(const std::string& filename) {
+	size_ = 0;
+
+	if (!file_.open(filename))
+		return false;
+
+	parse(file_.data(), file_.size());
+	return true;
+}
+
+void ConfigParser::parse(const char* data, size_t size) {
+	const char* end = data + size;
+
+	// one entry per line at most
+	size_t lines = 1;
+	for (const char* c = data; c != end && (c = static_cast<const char*>(std::memchr(c, '\n', end - c))); ++c)
+		++lines;
+
+	entries_.reset(new Entry[lines]);
+	size_ = 0;
+
+	StringView section;
+
+	for (const char* line = data; line < end;) {
+		const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+		if (!eol)
+			eol = end;
+
+		if (line != eol && *line != '#' && *line != ';') {
+			if (*line == '[') {
+				const char* close = static_cast<const char*>(std::memchr(line, ']', eol - line));
+				section = trimmed(line + 1, close ? close : eol);
+			}
+			else if (const char* equal = static_cast<const char*>(std::memchr(line, '=', eol - line))) {
+				Entry& entry = entries_[size_++];
+				entry.section_ = section;
+				entry.key_ = trimmed(line, equal);
+				entry.value_ = trimmed(equal + 1, eol);
+			}
+		}
+
+		line = eol + 1;
+	}
+
+	// equal keys stay in file order (their key views point into the same text), so the last one wins
+	std::sort(entries_.get(), entries_.get() + size_, [](const Entry& lhs, const Entry& rhs) {
+		int result = compare(lhs, rhs.section_, rhs.key_);
+		return result != 0 ? result < 0 : lhs.key_.data() < rhs.key_.data();
+	});
+
+	size_t unique = 0;
+	for (size_t i = 0; i < size_; ++i) {
+		if (unique > 0 && compare(entries_[unique - 1], entries_[i].section_, entries_[i].key_) == 0)
+			entries_[unique - 1] = entries_[i];
+		else
+			entries_[unique++] = entries_[i];
+	}
+
+	size_ = unique;
+}
+
+const ConfigParser::Entry* ConfigParser::find(StringView section, StringView key) const {
+	const Entry* begin = entries_.get();
+	const Entry* end = begin + size_;
+
+	auto it = std::lower_bound(begin, end, 0, [&section, &key](const Entry& entry, int) {
+		return compare(entry, section, key) < 0;
+	});
+
+	return it != end && compare(*it, section, key) == 0 ? it : nullptr;
+}
+
+FURRY_NS_END
@@ -0,0 +1,385 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+
+FURRY_NS_BEGIN
+
+namespace {
+	std::string qualifiedName(StringView section, StringView entry) {
+		std::string name;
+		name.reserve(section.size() + 1 + entry.size());
+		name.append(section.data(), section.size());
+		name.push_back('/');
+		name.append(entry.data(), entry.size());
+		return name;
+	}
+
+	/*
+	* Binary cache image, native byte order:
+	*   uint32 magic, uint32 version, int64 source mtime, uint64 source size, uint64 source hash, uint32 count
+	*   count times: uint16 name length, uint32 text length, double, int32, uint8 flags, name, text
+	*/
+	const std::uint32_t kCacheMagic = 0x43443246; // "F2DC"
+	const std::uint32_t kCacheVersion = 1;
+
+	enum CacheFlags : std::uint8_t {
+		kCacheBoolean = 1,
+		kCacheNumber = 2,
+		kCacheInteger = 4
+	};
+
+	// FNV-1a
+	std::uint64_t hash(const char* data, size_t size) {
+		std::uint64_t result = 14695981039346656037ull;
+
+		for (size_t i = 0; i < size; ++i) {
+			result ^= static_cast<unsigned char>(data[i]);
+			result *= 1099511628211ull;
+		}
+
+		return result;
+	}
+
+	// reads from a mapped image, failing instead of reading past its end
+	class CacheReader {
+	public:
+		CacheReader(const char* data, size_t size) : data_(data), end_(data + size) {}
+
+		template <typename T>
+		bool read(T& value) {
+			if (static_cast<size_t>(end_ - data_) < sizeof(T))
+				return false;
+
+			std::memcpy(&value, data_, sizeof(T));
+			data_ += sizeof(T);
+			return true;
+		}
+
+		bool read(StringView& str, size_t size) {
+			if (static_cast<size_t>(end_ - data_) < size)
+				return false;
+
+			str = StringView(data_, size);
+			data_ += size;
+			return true;
+		}
+
+	private:
+		const char* data_;
+		const char* end_;
+	};
+
+	// the content of a config file, mapped or copied
+	class SourceFile {
+	public:
+		SourceFile() : data_(nullptr), size_(0) {}
+
+		bool open(const std::string& filename, ConfigAccess access) {
+			if (access == ConfigAccess::Mapped) {
+				if (!mapped_.open(filename))
+					return false;
+
+				data_ = mapped_.data();
+				size_ = mapped_.size();
+				return true;
+			}
+
+			std::ifstream in(filename, std::ios::binary);
+			if (!in.good())
+				return false;
+
+			copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			if (in.bad())
+				return false;
+
+			data_ = copy_.data();
+			size_ = copy_.size();
+			return true;
+		}
+
+		const char* data() const {
+			return data_;
+		}
+
+		size_t size() const {
+			return size_;
+		}
+
+	private:
+		MappedFile mapped_;
+		std::string copy_;
+		const char* data_;
+		size_t size_;
+	};
+
+	template <typename T>
+	void write(std::ostream& out, const T& value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+}
+
+struct ConfigStore::CacheStamp {
+	std::int64_t modified_;
+	std::uint64_t size_;
+	std::uint64_t hash_;
+};
+
+bool ConfigStore::stampOf(const std::string& filename, const char* data, size_t size, CacheStamp& stamp) {
+	struct stat info;
+	if (stat(filename.c_str(), &info) != 0)
+		return false;
+
+	stamp.modified_ = static_cast<std::int64_t>(info.st_mtime);
+	stamp.size_ = size;
+	stamp.hash_ = hash(data, size);
+	return true;
+}
+
+ConfigStore::ConfigStore() {
+}
+
+bool ConfigStore::load(const std::string& filename, ConfigAccess access) {
+	SourceFile source;
+	if (!source.open(filename, access))
+		return false;
+
+	ConfigParser parser;
+	parser.parse(source.data(), source.size());
+
+	add(parser);
+	return true;
+}
+
+bool ConfigStore::load(const std::string& filename, const std::string& cacheFile, ConfigAccess access) {
+	SourceFile source;
+	CacheStamp stamp;
+
+	if (!source.open(filename, access) || !stampOf(filename, source.data(), source.size(), stamp))
+		return false;
+
+	if (loadCache(cacheFile, stamp))
+		return true;
+
+	ConfigParser parser;
+	parser.parse(source.data(), source.size());
+
+	if (!saveCache(cacheFile, stamp, parser))
+		gLogWarning << "Failed to write config cache: " << cacheFile;
+
+	add(parser);
+	return true;
+}
+
+bool ConfigStore::loadCache(const std::string& cacheFile, const CacheStamp& stamp) {
+	MappedFile image;
+	if (!image.open(cacheFile))
+		return false;
+
+	CacheReader header(image.data(), image.size());
+	std::uint32_t magic = 0, version = 0, count = 0;
+	CacheStamp cached = {};
+
+	if (!header.read(magic) || !header.read(version) || magic != kCacheMagic || version != kCacheVersion ||
+		!header.read(cached.modified_) || !header.read(cached.size_) || !header.read(cached.hash_) || !header.read(count))
+		return false;
+
+	if (cached.modified_ != stamp.modified_ || cached.size_ != stamp.size_ || cached.hash_ != stamp.hash_)
+		return false;
+
+	// check the whole image before changing anything
+	for (int pass = 0; pass < 2; ++pass) {
+		CacheReader in = header;
+
+		if (pass == 1) {
+			index_.reserve(index_.size() + count);
+			slots_.reserve(slots_.size() + count);
+		}
+
+		for (std::uint32_t i = 0; i < count; ++i) {
+			std::uint16_t nameLength;
+			std::uint32_t textLength;
+			double number;
+			std::int32_t integer;
+			std::uint8_t flags;
+			StringView name, text;
+
+			if (!in.read(nameLength) || !in.read(textLength) || !in.read(number) || !in.read(integer) || !in.read(flags) ||
+				!in.read(name, nameLength) || !in.read(text, textLength))
+				return false;
+
+			if (pass == 0)
+				continue;
+
+			Slot& slot = slots_[key(name).index_];
+			slot.text_.assign(text.data(), text.size());
+			slot.number_ = number;
+			slot.integer_ = integer;
+			slot.boolean_ = (flags & kCacheBoolean) != 0;
+			slot.is_number_ = (flags & kCacheNumber) != 0;
+			slot.is_integer_ = (flags & kCacheInteger) != 0;
+			slot.is_set_ = true;
+		}
+	}
+
+	return true;
+}
+
+bool ConfigStore::saveCache(const std::string& cacheFile, const CacheStamp& stamp, const ConfigParser& parser) const {
+	// written next to the cache and renamed, so other instances never map a half-written image
+	std::string temporary = cacheFile + ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if (!out.good())
+			return false;
+
+		write(out, kCacheMagic);
+		write(out, kCacheVersion);
+		write(out, stamp.modified_);
+		write(out, stamp.size_);
+		write(out, stamp.hash_);
+		write(out, static_cast<std::uint32_t>(parser.size()));
+
+		Slot slot;
+		for (auto&& entry : parser.entries()) {
+			std::string name = qualifiedName(entry.section_, entry.key_);
+			convert(slot, entry.value_);
+
+			std::uint8_t flags =
+				(slot.boolean_ ? kCacheBoolean : 0) |
+				(slot.is_number_ ? kCacheNumber : 0) |
+				(slot.is_integer_ ? kCacheInteger : 0);
+
+			write(out, static_cast<std::uint16_t>(name.size()));
+			write(out, static_cast<std::uint32_t>(slot.text_.size()));
+			write(out, slot.number_);
+			write(out, static_cast<std::int32_t>(slot.integer_));
+			write(out, flags);
+			out.write(name.data(), name.size());
+			out.write(slot.text_.data(), slot.text_.size());
+		}
+
+		if (!out.good())
+			return false;
+	}
+
+	std::remove(cacheFile.c_str()); // rename does not replace existing files everywhere
+	return std::rename(temporary.c_str(), cacheFile.c_str()) == 0;
+}
+
+void ConfigStore::parse(const std::string& content) {
+	ConfigParser parser;
+	parser.parse(content.data(), content.size());
+
+	add(parser);
+}
+
+void ConfigStore::add(const ConfigParser& parser) {
+	index_.reserve(index_.size() + parser.size());
+	slots_.reserve(slots_.size() + parser.size());
+
+	for (auto&& entry : parser.entries())
+		set(key(entry.section_, entry.key_), entry.value_);
+}
+
+ConfigKey ConfigStore::key(StringView section, StringView entry) {
+	return key(qualifiedName(section, entry));
+}
+
+ConfigKey ConfigStore::key(StringView name) {
+	auto result = index_.insert(std::make_pair(name.str(), static_cast<std::uint32_t>(slots_.size())));
+
+	if (result.second) {
+		slots_.emplace_back();
+		slots_.back().name_ = result.first->first;
+	}
+
+	return ConfigKey(result.first->second);
+}
+
+ConfigKey ConfigStore::find(StringView section, StringView entry) const {
+	auto it = index_.find(qualifiedName(section, entry));
+	return it == index_.end() ? ConfigKey() : ConfigKey(it->second);
+}
+
+void ConfigStore::set(ConfigKey key, StringView value) {
+	if (key.isValid())
+		convert(slots_[key.index_], value);
+}
+
+void ConfigStore::clear() {
+	for (auto&& slot : slots_) {
+		std::string name = std::move(slot.name_);
+		slot = Slot();
+		slot.name_ = std::move(name);
+	}
+}
+
+const std::string& ConfigStore::name(ConfigKey key) const {
+	static const std::string kNone;
+	return key.isValid() && key.index_ < slots_.size() ? slots_[key.index_].name_ : kNone;
+}
+
+std::vector<ConfigKey> ConfigStore::changes(const ConfigStore& other) const {
+	std::vector<ConfigKey> changed;
+
+	for (std::uint32_t i = 0; i < other.slots_.size(); ++i) {
+		const Slot& theirs = other.slots_[i];
+
+		if (i >= slots_.size()) { // a key that only exists in other
+			if (theirs.is_set_)
+				changed.push_back(ConfigKey(i));
+			continue;
+		}
+
+		const Slot& ours = slots_[i];
+		if (ours.is_set_ != theirs.is_set_ || ours.text_ != theirs.text_)
+			changed.push_back(ConfigKey(i));
+	}
+
+	return changed;
+}
+
+void ConfigStore::convert(Slot& slot, StringView value) {
+	slot.text_.assign(value.data(), value.size()); // also terminates the text for strtod and strtol
+
+	const char* begin = slot.text_.c_str();
+	const char* end = begin + slot.text_.size();
+	char* parsed;
+
+	slot.is_set_ = true;
+
+	errno = 0;
+	double number = std::strtod(begin, &parsed);
+	slot.is_number_ = parsed == end && parsed != begin && errno == 0;
+	slot.number_ = slot.is_number_ ? number : 0.0;
+
+	errno = 0;
+	long integer = std::strtol(begin, &parsed, 10);
+	slot.is_integer_ = parsed == end && parsed != begin && errno == 0 &&
+		integer >= std::numeric_limits<int>::min() && integer <= std::numeric_limits<int>::max();
+	slot.integer_ = slot.is_integer_ ? static_cast<int>(integer) : 0;
+
+	// same rule as ConfigFile::Conversion
+	slot.boolean_ = !(slot.text_ == "false" || slot.text_ == "0");
+}
+
+FURRY_NS_END
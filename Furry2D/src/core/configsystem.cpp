@@ -0,0 +1,148 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+FURRY_NS_BEGIN
+
+Config::Config() :
+	System("Config"),
+	is_watching_(false),
+	use_cache_(false)
+{
+}
+
+Config::~Config() {
+	stopWatching();
+}
+
+bool Config::load(const std::string& filename) {
+	std::lock_guard<std::mutex> lock(writer_mutex_);
+
+	// nothing is changed if the file can't be read
+	if (!loadInto(latest_, filename, ConfigAccess::Mapped)) {
+		gLogDebug << "Failed to open config file: " << filename;
+		return false;
+	}
+
+	store_.publish(ConfigStore(latest_));
+	files_.push_back(filename);
+
+	if (watcher_ && !watcher_->add(filename))
+		gLogWarning << "Failed to watch config file: " << filename;
+
+	return true;
+}
+
+ConfigKey Config::key(std::string const& section, std::string const& entry) {
+	ConfigKey key = store_.read()->find(section, entry);
+	if (key.isValid())
+		return key;
+
+	// not published, the key has no value until the next load() or reload()
+	std::lock_guard<std::mutex> lock(writer_mutex_);
+	return latest_.key(section, entry);
+}
+
+void Config::enableHotReload() {
+	std::lock_guard<std::mutex> lock(writer_mutex_);
+
+	if (watcher_)
+		return;
+
+	watcher_.reset(new FileWatcher);
+
+	for (auto&& filename : files_)
+		if (!watcher_->add(filename))
+			gLogWarning << "Failed to watch config file: " << filename;
+}
+
+bool Config::reload() {
+	std::vector<ConfigChanged> changes;
+	{
+		std::lock_guard<std::mutex> lock(writer_mutex_);
+
+		// same keys as before, so handles stay valid
+		ConfigStore store(latest_);
+		store.clear();
+
+		// copied, the files are likely still being written
+		for (auto&& filename : files_) {
+			if (!loadInto(store, filename, ConfigAccess::Copied)) {
+				gLogWarning << "Failed to reload config file: " << filename << ", keeping the current values";
+				return false;
+			}
+		}
+
+		for (auto key : store_.share()->changes(store))
+			changes.push_back(ConfigChanged{ key, store.name(key) });
+
+		if (!changes.empty()) {
+			latest_ = store;
+			store_.publish(std::move(store));
+		}
+	}
+
+	gLog << "Config reloaded, " << changes.size() << " values changed";
+
+	for (auto&& change : changes)
+		Channel::post(std::move(change));
+
+	return true;
+}
+
+bool Config::loadInto(ConfigStore& store, const std::string& filename, ConfigAccess access) const {
+	return use_cache_ ? store.load(filename, filename + ".cache", access) : store.load(filename, access);
+}
+
+bool Config::initialize() {
+	if (watcher_ && !watching_.joinable()) {
+		is_watching_ = true;
+		watching_ = std::thread(&Config::watch, this);
+	}
+
+	return true;
+}
+
+void Config::update() {
+	if (!watcher_ || watching_.joinable())
+		return;
+
+	if (!watcher_->wait(std::chrono::milliseconds(0)).empty())
+		reload();
+}
+
+void Config::shutdown() {
+	stopWatching();
+}
+
+void Config::watch() {
+	Profiler::setThreadName("config watcher");
+
+	// the timeout bounds how long stopWatching() waits for this thread
+	while (is_watching_)
+		if (!watcher_->wait(std::chrono::milliseconds(100)).empty())
+			reload();
+}
+
+void Config::stopWatching() {
+	if (!watching_.joinable())
+		return;
+
+	is_watching_ = false;
+	watching_.join();
+}
+
+FURRY_NS_END
@@ -14,6 +14,7 @@
 */
 
 #include <furry2d/furry2d.h>
+#include <algorithm>
 #include <cassert>
 
 namespace {
@@ -24,12 +25,15 @@ namespace {
 
 FURRY_NS_BEGIN
 
-Engine::Engine() {
+Engine::Engine() :
+	systems_added_(0)
+{
 	Channel::add<OnStop>(this);
 }
 
 Engine::~Engine() {
 	stop();
+	Channel::remove<OnStop>(this);
 }
 
 void Engine::setApplication(Application* application) {
@@ -45,15 +49,19 @@ void Engine::setApplication(std::unique_ptr<Application>&& application) {
 	}
 }
 
-void Engine::add(System* system) {
-	add(std::unique_ptr<System>(system));
-}
-
-void Engine::add(std::unique_ptr<System>&& system) {
+void Engine::add(std::unique_ptr<System>&& system, size_t typeIndex) {
 	auto it = system_lookup_.find(system->getName());
 
 	if (it == system_lookup_.end()) {
 		system->engine_ = this;
+		system->type_index_ = typeIndex;
+		system->position_ = systems_.size();
+		system->order_ = systems_added_++;
+
+		if (typeIndex >= system_index_.size())
+			system_index_.resize(typeIndex + 1);
+
+		system_index_[typeIndex].push_back(system.get()); // the first system of a type is the one get<T>() returns
 
 		system_lookup_[system->getName()] = system.get();
 		systems_.emplace_back(std::move(system));
@@ -79,33 +87,38 @@ void Engine::remove(std::string systemName) {
 }
 
 void Engine::remove(System* s) {
-	// first scan the systemlist for the given system
-	auto it = std::remove_if(
-		systems_.begin(),
-		systems_.end(),
-		[s](const SystemPtr& ptr) {
-			return ptr.get() == s;
-		}
-	);
+	if (!s || s->position_ >= systems_.size() || systems_[s->position_].get() != s)
+		return;
 
-	if (it != systems_.end()) {
-		// the system was found, perform a clean shutdown and remove it from the active registry/list
-		s->shutdown();
+	// perform a clean shutdown and remove it from the active registry/list
+	s->shutdown();
+	frame_stats_.detach(s);
 
-		systems_.erase(it);
+	// the next system of the type, if there is one, is what get<T>() returns from now on
+	auto& ofType = system_index_[s->type_index_];
+	ofType.erase(std::find(ofType.begin(), ofType.end(), s));
 
-		for (auto jt = system_lookup_.begin(); jt != system_lookup_.end(); ++jt) {
-			if (jt->second == s) {
-				system_lookup_.erase(jt);
-				break;
-			}
-		}
-	}
+	system_lookup_.erase(s->getName());
+
+	// the last system takes its place, so nothing else moves
+	size_t position = s->position_;
+	std::swap(systems_[position], systems_.back());
+	systems_[position]->position_ = position;
+	systems_.pop_back();
 }
 
 void Engine::run() {
 	if (initializeDependencies()) {
 		initializeSystems();
+
+		// the end of every main-thread pass is the frame boundary for posted events and main lane deliveries
+		task_processor_.addRepeatingWork([this] {
+			Lane::main().drain();
+			Channel::dispatch();
+			FlightRecorder::markFrame();
+			frame_stats_.endFrame();
+		});
+
 		task_processor_.start();
 		shutdownSystems();
 		shutdownDependencies();
@@ -133,11 +146,11 @@ void Engine::initializeSystems() {
 	// try and load a config file
 	//mConfig.load("default.cfg");
 
-	// now perform per-system initialization
-	for (auto& system : systems_) {
+	// now perform per-system initialization, independent systems concurrently
+	runSystemGraph(false, [](System* system) {
 		if (!system->initialize())
 			gLogError << "Failed to initialize subsystem: " << system->getName();
-	}
+	});
 
 	// if an application was set, initialize it as well
 	if (application_)
@@ -149,11 +162,77 @@ void Engine::shutdownSystems() {
 	if (application_)
 		application_->shutdown();
 
-	for (auto& system : systems_)
+	// in reverse dependency order
+	runSystemGraph(true, [](System* system) {
 		system->shutdown();
+	});
+
+	for (auto& system : systems_)
+		frame_stats_.detach(system.get());
 
 	systems_.clear();
 	system_lookup_.clear();
+	system_index_.clear();
+}
+
+void Engine::runSystemGraph(bool reversed, const std::function<void(System*)>& action) {
+	// in the order they were added, which is also the fallback for cyclic dependencies (reversed if asked to)
+	std::vector<System*> ordered;
+	ordered.reserve(systems_.size());
+
+	for (auto&& system : systems_)
+		ordered.push_back(system.get());
+
+	std::sort(ordered.begin(), ordered.end(), [](const System* a, const System* b) {
+		return a->order_ < b->order_;
+	});
+
+	std::map<System*, size_t> positions;
+	for (size_t i = 0; i < ordered.size(); ++i)
+		positions[ordered[i]] = i;
+
+	std::vector<TaskProcessor::GraphTask> tasks(ordered.size());
+
+	for (size_t i = 0; i < ordered.size(); ++i) {
+		System* system = ordered[i];
+
+		tasks[i].task_ = [system, &action] {
+			try {
+				action(system);
+			}
+			catch (const std::exception& e) {
+				gLogError << "Exception in subsystem " << system->getName() << ": " << e.what();
+			}
+		};
+		tasks[i].is_main_thread_only_ = system->isMainThreadOnly();
+
+		for (auto&& name : system->getDependencies()) {
+			auto it = system_lookup_.find(name);
+
+			if (it == system_lookup_.end()) {
+				gLogWarning << "Subsystem " << system->getName() << " depends on unknown subsystem " << name;
+				continue;
+			}
+
+			size_t dependency = positions[it->second];
+
+			if (reversed)
+				tasks[dependency].dependencies_.push_back(i);
+			else
+				tasks[i].dependencies_.push_back(dependency);
+		}
+	}
+
+	if (!task_processor_.runGraph(tasks)) {
+		gLogError << "Subsystem dependencies are cyclic, falling back to the order the subsystems were added in";
+
+		if (reversed)
+			for (auto it = tasks.rbegin(); it != tasks.rend(); ++it)
+				it->task_();
+		else
+			for (auto&& task : tasks)
+				task.task_();
+	}
 }
 
 bool Engine::initializeDependencies() {
@@ -176,12 +255,17 @@ void Engine::shutdownDependencies() {
 void Engine::updateSystem(System* system, bool repeating, bool background) {
 	assert(system);
 
+	// background systems do not run as part of a frame, so they are not accounted for
+	FrameStats::Counter* cost = background ? nullptr : frame_stats_.counter(system->getName(), system);
+
 	task_processor_.addWork(
-		[system] { 
+		[system, cost] { 
+			FrameStats::Scope scope(cost);
 			system->update(); 
 		}, 
 		repeating, 
-		background
+		background,
+		system->getName()
 	);
 }
 
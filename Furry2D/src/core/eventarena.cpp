@@ -0,0 +1,112 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <thread>
+
+FURRY_NS_BEGIN
+
+EventArena::EventArena(size_t bytesPerFrame) :
+	bytes_per_frame_(bytesPerFrame),
+	current_(0)
+{
+	for (auto& frame : frames_)
+		frame.memory_.reset(new char[bytes_per_frame_]);
+}
+
+EventArena::~EventArena() {
+}
+
+EventArena& EventArena::instance() {
+	static EventArena arena;
+	return arena;
+}
+
+void* EventArena::allocate(size_t size, size_t alignment) {
+	for (;;) {
+		size_t index = current_.load();
+		Frame& frame = frames_[index];
+
+		// advance() does not recycle a frame while allocations are in flight in it
+		frame.in_flight_.fetch_add(1);
+
+		void* result = current_.load() == index ? allocateIn(frame, size, alignment) : nullptr;
+
+		// a frame that is not current anymore may be recycled before the payload is posted,
+		// so try again in the new one (the space is wasted until the frame is recycled)
+		bool isCurrent = current_.load() == index;
+		frame.in_flight_.fetch_sub(1);
+
+		if (result && isCurrent)
+			return result;
+	}
+}
+
+void* EventArena::allocateIn(Frame& frame, size_t size, size_t alignment) {
+	// reserve enough to align the result inside the reserved range
+	size_t reserved = size + alignment - 1;
+	size_t offset = frame.offset_.fetch_add(reserved, std::memory_order_relaxed);
+
+	if (offset + reserved <= bytes_per_frame_) {
+		auto address = reinterpret_cast<std::uintptr_t>(frame.memory_.get() + offset);
+		address = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+		return reinterpret_cast<void*>(address);
+	}
+
+	// frame is full, fall back to the heap; freed in bulk like everything else
+	std::unique_ptr<char[]> block(new char[reserved]);
+	auto address = reinterpret_cast<std::uintptr_t>(block.get());
+	address = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+
+	std::lock_guard<std::mutex> lock(frame.overflow_mutex_);
+	frame.overflow_.push_back(std::move(block));
+
+	return reinterpret_cast<void*>(address);
+}
+
+PooledString EventArena::copy(const char* data, size_t size) {
+	char* memory = static_cast<char*>(allocate(size + 1, 1));
+	std::memcpy(memory, data, size);
+	memory[size] = '\0';
+
+	return PooledString(memory, size);
+}
+
+void EventArena::advance() {
+	size_t next = (current_.load() + 1) % kFrameCount;
+	Frame& frame = frames_[next];
+
+	// only allocations that are about to notice that this frame is not current can be in flight
+	while (frame.in_flight_.load() != 0)
+		std::this_thread::yield();
+
+	// this slot was last handed out kFrameCount - 1 dispatches ago, everything in it has been delivered
+	frame.offset_.store(0, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(frame.overflow_mutex_);
+		frame.overflow_.clear();
+	}
+
+	current_.store(next, std::memory_order_release);
+}
+
+size_t EventArena::overflowCount() const {
+	const Frame& frame = frames_[current_.load()];
+
+	std::lock_guard<std::mutex> lock(frame.overflow_mutex_);
+	return frame.overflow_.size();
+}
+
+FURRY_NS_END
@@ -0,0 +1,160 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+FURRY_NS_BEGIN
+
+namespace {
+	const size_t kChunkSize = 64 * 1024;
+
+	template <typename T>
+	void append(std::vector<char>& buffer, const T& value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	template <typename T>
+	bool read(std::istream& in, T& value) {
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+/*** EventRecorder ***/
+EventRecorder::EventRecorder(const std::string& filename) :
+	start_(std::chrono::steady_clock::now()),
+	file_(std::make_shared<std::ofstream>(filename, std::ios::binary))
+{
+	if (!file_->good())
+		throw std::runtime_error(std::string("Failed to open event journal: ") + filename);
+
+	std::uint32_t magic = EventJournal::kMagic;
+	std::uint32_t version = EventJournal::kVersion;
+	file_->write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	file_->write(reinterpret_cast<const char*>(&version), sizeof(version));
+
+	staging_.reserve(kChunkSize);
+	writer_ = Active::create();
+}
+
+EventRecorder::~EventRecorder() {
+	taps_.clear(); // no new records from here on
+	flush();
+	writer_.reset(); // drains the pending writes
+}
+
+void EventRecorder::recordInput() {
+	record<GLFWApplication::KeyInput>(EventJournal::kKeyInput);
+	record<GLFWApplication::MouseButtonInput>(EventJournal::kMouseButtonInput);
+	record<GLFWApplication::MouseMoveInput>(EventJournal::kMouseMoveInput);
+	record<GLFWApplication::MouseScrollInput>(EventJournal::kMouseScrollInput);
+}
+
+void EventRecorder::flush() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	flushLocked();
+}
+
+void EventRecorder::write(std::uint32_t typeId, const void* data, std::uint32_t size) {
+	using namespace std::chrono;
+	std::uint64_t timestamp = duration_cast<nanoseconds>(steady_clock::now() - start_).count();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	append(staging_, timestamp);
+	append(staging_, typeId);
+	append(staging_, size);
+	staging_.insert(staging_.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+
+	if (staging_.size() >= kChunkSize)
+		flushLocked();
+}
+
+void EventRecorder::flushLocked() {
+	if (staging_.empty())
+		return;
+
+	auto chunk = std::make_shared<std::vector<char>>();
+	chunk->reserve(kChunkSize);
+	chunk->swap(staging_);
+
+	auto file = file_;
+	writer_->send([file, chunk] {
+		file->write(chunk->data(), chunk->size());
+		file->flush();
+	});
+}
+
+/*** EventReplayer ***/
+EventReplayer::EventReplayer(const std::string& filename) : filename_(filename) {
+}
+
+void EventReplayer::replayInput() {
+	replay<GLFWApplication::KeyInput>(EventJournal::kKeyInput);
+	replay<GLFWApplication::MouseButtonInput>(EventJournal::kMouseButtonInput);
+	replay<GLFWApplication::MouseMoveInput>(EventJournal::kMouseMoveInput);
+	replay<GLFWApplication::MouseScrollInput>(EventJournal::kMouseScrollInput);
+}
+
+size_t EventReplayer::run(Timing timing) {
+	std::ifstream file(filename_, std::ios::binary);
+
+	std::uint32_t magic = 0, version = 0;
+	if (!read(file, magic) || !read(file, version) || magic != EventJournal::kMagic)
+		throw std::runtime_error(std::string("Not an event journal: ") + filename_);
+
+	if (version != EventJournal::kVersion)
+		throw std::runtime_error(std::string("Unsupported event journal version: ") + filename_);
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<char> payload;
+	size_t count = 0;
+
+	std::uint64_t timestamp;
+	std::uint32_t typeId, size;
+
+	while (read(file, timestamp) && read(file, typeId) && read(file, size)) {
+		if (size > EventJournal::kMaxRecordSize) { // garbage where a record header should be
+			gLogWarning << "Event journal is truncated: " << filename_;
+			break;
+		}
+
+		payload.resize(size);
+
+		if (size > 0 && !file.read(payload.data(), size)) {
+			gLogWarning << "Event journal is truncated: " << filename_;
+			break;
+		}
+
+		auto it = decoders_.find(typeId);
+		if (it == decoders_.end())
+			continue;
+
+		if (timing == Timing::Original)
+			std::this_thread::sleep_until(start + std::chrono::nanoseconds(timestamp));
+
+		if (it->second(payload.data(), size))
+			++count;
+		else
+			gLogWarning << "Event journal record of type " << typeId << " has an unexpected size (" << size << ")";
+	}
+
+	return count;
+}
+
+FURRY_NS_END
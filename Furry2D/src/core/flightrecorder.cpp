@@ -0,0 +1,551 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+
+#ifdef FURRY_PLATFORM_WINDOWS
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
+FURRY_NS_BEGIN
+
+namespace {
+	enum class EntryKind : std::uint8_t {
+		Log, Event, Frame
+	};
+
+	struct EntryData {
+		std::uint64_t ticks_;
+		const LogDescriptor* descriptor_; // set for structured records, text_ then holds the encoded arguments
+		std::int32_t line_;
+		LogLevel level_;
+		EntryKind kind_;
+		std::uint16_t length_;
+		char file_[FlightRecorder::kFileCapacity];
+		char text_[FlightRecorder::kTextCapacity];
+	};
+
+	const size_t kEntryWords = sizeof(EntryData) / sizeof(std::uint64_t);
+	static_assert(sizeof(EntryData) % sizeof(std::uint64_t) == 0, "entries are copied word by word");
+
+	// the data is stored in relaxed atomic words, so dump() can copy it while a writer overwrites it
+	struct Entry {
+		std::atomic<std::uint64_t> sequence_; // 2 * index + 1 while being written, 2 * index + 2 once complete
+		std::atomic<std::uint64_t> words_[kEntryWords];
+	};
+
+
+	// static storage, so recording and dumping never allocate and need no initialization
+	Entry gEntries[FlightRecorder::kCapacity];
+	std::atomic<std::uint64_t> gHead(0);
+	std::atomic<std::uint64_t> gFrames(0);
+
+	char gDumpFile[512] = "Furry2d-flight.bin";
+	std::atomic<bool> gHasCrashed(false);
+	std::terminate_handler gPreviousTerminate = nullptr;
+
+	// calibration of MonotonicClock, captured outside of signal handlers (see calibrate())
+	std::atomic<bool> gIsCalibrated(false);
+	std::uint64_t gFrequency = 1;
+	std::uint64_t gBaseTicks = 0;
+	std::int64_t gBaseWall = 0;
+
+	void calibrate() {
+		static std::once_flag once;
+
+		std::call_once(once, [] {
+			gFrequency = MonotonicClock::frequency();
+			gBaseTicks = MonotonicClock::ticks();
+			gBaseWall = static_cast<std::int64_t>(MonotonicClock::sinceEpoch(gBaseTicks).count());
+			gIsCalibrated.store(true, std::memory_order_release);
+		});
+	}
+
+	// same as MonotonicClock::sinceEpoch, but async-signal-safe
+	std::uint64_t sinceEpoch(std::uint64_t ticks) {
+		if (!gIsCalibrated.load(std::memory_order_acquire))
+			return 0;
+
+		auto nanoseconds = [](std::uint64_t delta) {
+			return static_cast<std::int64_t>((delta / gFrequency) * 1000000000ull + (delta % gFrequency) * 1000000000ull / gFrequency);
+		};
+
+		return static_cast<std::uint64_t>(ticks >= gBaseTicks ?
+			gBaseWall + nanoseconds(ticks - gBaseTicks) :
+			gBaseWall - nanoseconds(gBaseTicks - ticks));
+	}
+
+	void publish(const EntryData& data) {
+		std::uint64_t index = gHead.fetch_add(1, std::memory_order_relaxed);
+
+		Entry& entry = gEntries[index & (FlightRecorder::kCapacity - 1)];
+		entry.sequence_.store(index * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		// only the used part of the text
+		size_t size = offsetof(EntryData, text_) + data.length_;
+		size_t words = std::min((size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t), kEntryWords);
+
+		std::uint64_t copy[kEntryWords];
+		std::memcpy(copy, &data, words * sizeof(std::uint64_t));
+
+		for (size_t i = 0; i < words; ++i)
+			entry.words_[i].store(copy[i], std::memory_order_relaxed);
+
+		entry.sequence_.store(index * 2 + 2, std::memory_order_release);
+	}
+
+	// keeps the end of the path, that's the interesting part
+	void copyFile(EntryData& entry, const char* file) {
+		if (!file) {
+			entry.file_[0] = '\0';
+			return;
+		}
+
+		size_t length = std::strlen(file);
+		size_t skip = length >= FlightRecorder::kFileCapacity ? length - FlightRecorder::kFileCapacity + 1 : 0;
+
+		std::memcpy(entry.file_, file + skip, length - skip);
+		entry.file_[length - skip] = '\0';
+	}
+
+	void copyText(EntryData& entry, const char* text, size_t length) {
+		length = std::min(length, FlightRecorder::kTextCapacity);
+
+		std::memcpy(entry.text_, text, length);
+		entry.length_ = static_cast<std::uint16_t>(length);
+	}
+
+	// unbuffered file output with a stack buffer, only uses async-signal-safe calls
+	class SignalSafeFile {
+	public:
+		explicit SignalSafeFile(const char* filename) : size_(0) {
+#ifdef FURRY_PLATFORM_WINDOWS
+			fd_ = _open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+			fd_ = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+		}
+
+		~SignalSafeFile() {
+			if (fd_ < 0)
+				return;
+
+			flush();
+#ifdef FURRY_PLATFORM_WINDOWS
+			_close(fd_);
+#else
+			::close(fd_);
+#endif
+		}
+
+		bool isOpen() const {
+			return fd_ >= 0;
+		}
+
+		template <typename T>
+		void write(const T& value) {
+			write(&value, sizeof(T));
+		}
+
+		template <typename tLength>
+		void writeString(const char* data, size_t size) {
+			write(static_cast<tLength>(size));
+			write(data, size);
+		}
+
+		void write(const void* data, size_t size) {
+			const char* bytes = static_cast<const char*>(data);
+
+			while (size > 0) {
+				if (size_ == sizeof(buffer_))
+					flush();
+
+				size_t chunk = std::min(size, sizeof(buffer_) - size_);
+				std::memcpy(buffer_ + size_, bytes, chunk);
+
+				size_ += chunk;
+				bytes += chunk;
+				size -= chunk;
+			}
+		}
+
+	private:
+		void flush() {
+#ifdef FURRY_PLATFORM_WINDOWS
+			_write(fd_, buffer_, static_cast<unsigned int>(size_));
+#else
+			ssize_t result = ::write(fd_, buffer_, size_);
+			(void)result;
+#endif
+			size_ = 0;
+		}
+
+		int fd_;
+		size_t size_;
+		char buffer_[4096];
+	};
+
+	void dumpOnCrash() {
+		if (!gHasCrashed.exchange(true)) // std::terminate usually ends in SIGABRT, dump only once
+			FlightRecorder::dump(gDumpFile);
+	}
+
+	void onSignal(int signal) {
+		dumpOnCrash();
+
+		std::signal(signal, SIG_DFL);
+		std::raise(signal);
+	}
+
+	void installHandler(int signal) {
+#ifdef FURRY_PLATFORM_WINDOWS
+		std::signal(signal, &onSignal);
+#else
+		// on the alternate stack, so a stack overflow can still be dumped
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_handler = &onSignal;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_ONSTACK | SA_RESETHAND;
+
+		sigaction(signal, &action, nullptr);
+#endif
+	}
+
+#ifndef FURRY_PLATFORM_WINDOWS
+	const size_t kAlternateStackSize = 64 * 1024;
+
+	// the alternate signal stack of one thread
+	struct AlternateStack {
+		AlternateStack() : memory_(nullptr) {}
+
+		~AlternateStack() {
+			if (!memory_)
+				return;
+
+			stack_t disable;
+			std::memset(&disable, 0, sizeof(disable));
+			disable.ss_flags = SS_DISABLE;
+
+			sigaltstack(&disable, nullptr);
+			delete[] memory_;
+		}
+
+		char* memory_;
+	};
+#endif
+
+	void onTerminate() {
+		dumpOnCrash();
+
+		if (gPreviousTerminate)
+			gPreviousTerminate();
+
+		std::abort();
+	}
+
+	class Watchdog {
+	public:
+		Watchdog() : is_running_(false) {}
+
+		~Watchdog() {
+			stop();
+		}
+
+		void start(std::chrono::milliseconds timeout) {
+			stop();
+
+			is_running_ = true;
+			thread_ = std::thread([this, timeout] {
+				std::uint64_t lastFrame = gFrames.load();
+				auto lastProgress = std::chrono::steady_clock::now();
+				bool hasDumped = false;
+
+				std::unique_lock<std::mutex> lock(mutex_);
+
+				while (is_running_) {
+					wakeup_.wait_for(lock, timeout / 4);
+
+					std::uint64_t frame = gFrames.load();
+					auto now = std::chrono::steady_clock::now();
+
+					if (frame != lastFrame) {
+						lastFrame = frame;
+						lastProgress = now;
+						hasDumped = false;
+					}
+					else if (!hasDumped && now - lastProgress >= timeout) {
+						gLogError << "No frame for " << timeout.count() << " ms, dumping the flight recorder to " << gDumpFile;
+						FlightRecorder::dump(gDumpFile);
+						hasDumped = true; // once per stall
+					}
+				}
+			});
+		}
+
+		void stop() {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				is_running_ = false;
+			}
+			wakeup_.notify_all();
+
+			if (thread_.joinable())
+				thread_.join();
+		}
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable wakeup_;
+		bool is_running_;
+		std::thread thread_;
+	};
+
+	Watchdog& watchdog() {
+		static Watchdog watchdog;
+		return watchdog;
+	}
+}
+
+std::atomic<bool> FlightRecorder::is_enabled_(false);
+
+const size_t FlightRecorder::kCapacity;
+const size_t FlightRecorder::kTextCapacity;
+const size_t FlightRecorder::kFileCapacity;
+
+void FlightRecorder::setEnabled(bool enabled) {
+	calibrate(); // before anything is recorded
+	is_enabled_.store(enabled);
+}
+
+void FlightRecorder::record(LogLevel level, const char* file, int line, const char* text, size_t length, std::uint64_t ticks) {
+	EntryData entry;
+
+	entry.ticks_ = ticks;
+	entry.descriptor_ = nullptr;
+	entry.line_ = line;
+	entry.level_ = level;
+	entry.kind_ = EntryKind::Log;
+	copyFile(entry, file);
+	copyText(entry, text, length);
+
+	publish(entry);
+}
+
+void FlightRecorder::record(const LogRecord& record) {
+	EntryData entry;
+
+	entry.ticks_ = record.timestamp_;
+	entry.descriptor_ = record.descriptor_;
+	entry.line_ = record.line_;
+	entry.level_ = record.level_;
+	entry.kind_ = EntryKind::Log;
+	copyFile(entry, record.file_);
+	copyText(entry, record.text_, record.length_);
+
+	publish(entry);
+}
+
+void FlightRecorder::recordEvent(const char* text, const char* file, int line) {
+	EntryData entry;
+
+	entry.ticks_ = MonotonicClock::ticks();
+	entry.descriptor_ = nullptr;
+	entry.line_ = line;
+	entry.level_ = LogLevel::EDebug;
+	entry.kind_ = EntryKind::Event;
+	copyFile(entry, file);
+	copyText(entry, text, std::strlen(text));
+
+	publish(entry);
+}
+
+void FlightRecorder::markFrame() {
+	std::uint64_t frame = gFrames.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	if (!isEnabled())
+		return;
+
+	EntryData entry;
+
+	entry.ticks_ = MonotonicClock::ticks();
+	entry.descriptor_ = nullptr;
+	entry.line_ = 0;
+	entry.level_ = LogLevel::EDebug;
+	entry.kind_ = EntryKind::Frame;
+	entry.file_[0] = '\0';
+	std::memcpy(entry.text_, &frame, sizeof(frame)); // formatted when dumped
+	entry.length_ = sizeof(frame);
+
+	publish(entry);
+}
+
+std::uint64_t FlightRecorder::frameCount() {
+	return gFrames.load(std::memory_order_relaxed);
+}
+
+bool FlightRecorder::dump(const char* filename) {
+	SignalSafeFile file(filename);
+
+	if (!file.isOpen())
+		return false;
+
+	file.write(static_cast<std::uint32_t>(LogDecoder::kMagic));
+	file.write(static_cast<std::uint32_t>(LogDecoder::kVersion));
+
+	std::uint64_t head = gHead.load(std::memory_order_acquire);
+	std::uint64_t first = head > kCapacity ? head - kCapacity : 0;
+
+	for (std::uint64_t i = first; i < head; ++i) {
+		const Entry& slot = gEntries[i & (kCapacity - 1)];
+
+		if (slot.sequence_.load(std::memory_order_acquire) != i * 2 + 2)
+			continue; // still being written (or already overwritten)
+
+		// copy, then make sure no writer got in between
+		std::uint64_t copy[kEntryWords];
+		for (size_t w = 0; w < kEntryWords; ++w)
+			copy[w] = slot.words_[w].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence_.load(std::memory_order_relaxed) != i * 2 + 2)
+			continue;
+
+		EntryData entry;
+		std::memcpy(&entry, copy, sizeof(entry));
+
+		auto timestamp = sinceEpoch(entry.ticks_);
+
+		if (entry.descriptor_) {
+			// written with every record, the decoder simply overwrites it
+			const LogDescriptor& descriptor = *entry.descriptor_;
+			auto id = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(entry.descriptor_));
+
+			file.write(static_cast<std::uint8_t>(LogDecoder::kDescriptor));
+			file.write(id);
+			file.write(static_cast<std::uint8_t>(descriptor.level_));
+			file.write(static_cast<std::uint32_t>(descriptor.line_));
+			file.writeString<std::uint16_t>(descriptor.file_, std::strlen(descriptor.file_));
+			file.writeString<std::uint16_t>(descriptor.format_, std::strlen(descriptor.format_));
+
+			file.write(static_cast<std::uint8_t>(LogDecoder::kRecord));
+			file.write(id);
+			file.write(timestamp);
+			file.writeString<std::uint16_t>(entry.text_, entry.length_);
+			continue;
+		}
+
+		file.write(static_cast<std::uint8_t>(LogDecoder::kText));
+		file.write(timestamp);
+		file.write(static_cast<std::uint8_t>(entry.level_));
+		file.write(static_cast<std::uint32_t>(entry.line_));
+		file.writeString<std::uint16_t>(entry.file_, std::strlen(entry.file_));
+
+		if (entry.kind_ == EntryKind::Frame) {
+			// no snprintf here, it is not async-signal-safe
+			std::uint64_t frame;
+			std::memcpy(&frame, entry.text_, sizeof(frame));
+
+			char digits[32];
+			char* end = digits + sizeof(digits);
+			char* pos = end;
+			do {
+				*--pos = static_cast<char>('0' + frame % 10);
+				frame /= 10;
+			} while (frame);
+
+			const char kPrefix[] = "--- frame ";
+			file.write(static_cast<std::uint32_t>(sizeof(kPrefix) - 1 + (end - pos) + 4));
+			file.write(kPrefix, sizeof(kPrefix) - 1);
+			file.write(pos, end - pos);
+			file.write(" ---", 4);
+		}
+		else if (entry.kind_ == EntryKind::Event) {
+			const char kPrefix[] = "[event] ";
+			file.write(static_cast<std::uint32_t>(sizeof(kPrefix) - 1 + entry.length_));
+			file.write(kPrefix, sizeof(kPrefix) - 1);
+			file.write(entry.text_, entry.length_);
+		}
+		else
+			file.writeString<std::uint32_t>(entry.text_, entry.length_);
+	}
+
+	return true;
+}
+
+void FlightRecorder::installCrashHandler(const std::string& filename) {
+	size_t length = std::min(filename.size(), sizeof(gDumpFile) - 1);
+	std::memcpy(gDumpFile, filename.data(), length);
+	gDumpFile[length] = '\0';
+
+	calibrate();
+	installAlternateStack();
+
+	installHandler(SIGSEGV);
+	installHandler(SIGABRT);
+	installHandler(SIGFPE);
+	installHandler(SIGILL);
+#ifdef SIGBUS
+	installHandler(SIGBUS);
+#endif
+
+	std::terminate_handler previous = std::set_terminate(&onTerminate);
+	if (previous != &onTerminate)
+		gPreviousTerminate = previous;
+}
+
+void FlightRecorder::installAlternateStack() {
+#ifndef FURRY_PLATFORM_WINDOWS
+	static thread_local AlternateStack stack;
+
+	if (stack.memory_)
+		return;
+
+	stack.memory_ = new char[kAlternateStackSize];
+
+	stack_t alternate;
+	std::memset(&alternate, 0, sizeof(alternate));
+	alternate.ss_sp = stack.memory_;
+	alternate.ss_size = kAlternateStackSize;
+
+	if (sigaltstack(&alternate, nullptr) != 0) {
+		delete[] stack.memory_;
+		stack.memory_ = nullptr;
+	}
+#endif
+}
+
+void FlightRecorder::startWatchdog(std::chrono::milliseconds timeout) {
+	watchdog().start(timeout);
+}
+
+void FlightRecorder::stopWatchdog() {
+	watchdog().stop();
+}
+
+FURRY_NS_END
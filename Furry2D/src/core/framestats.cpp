@@ -0,0 +1,263 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+FURRY_NS_BEGIN
+
+namespace {
+	double milliseconds(std::uint64_t ticks) {
+		return std::chrono::duration<double, std::milli>(MonotonicClock::toDuration(ticks)).count();
+	}
+
+	std::int64_t microseconds(std::uint64_t ticks) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(MonotonicClock::toDuration(ticks)).count();
+	}
+
+	// copied out of a counter, it is reported after the mutex is released
+	struct Overrun {
+		System* system_;
+		std::string name_;
+		std::uint64_t ticks_;
+		std::int64_t budget_us_;
+	};
+}
+
+/*** Counter ***/
+FrameStats::Counter::Counter(std::string name, System* system) :
+	name_(std::move(name)),
+	system_(system),
+	frame_ticks_(0),
+	budget_us_(0),
+	last_ticks_(0),
+	total_ticks_(0),
+	max_ticks_(0),
+	frames_(0),
+	overruns_(0)
+{
+}
+
+void FrameStats::Counter::setBudget(std::chrono::microseconds budget) {
+	budget_us_.store(budget.count(), std::memory_order_relaxed);
+}
+
+/*** FrameStats ***/
+const size_t FrameStats::kHistory;
+
+FrameStats::FrameStats() :
+	frame_ticks_(kHistory, 0),
+	frames_(0),
+	frame_start_(0),
+	frame_budget_us_(0),
+	summary_interval_s_(0),
+	last_summary_(MonotonicClock::ticks())
+{
+}
+
+FrameStats::Counter* FrameStats::counter(const std::string& name, System* system) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto&& counter : counters_) {
+		if (counter->name_ == name) {
+			if (system) // e.g. a system added again after it was removed
+				counter->system_ = system;
+
+			return counter.get();
+		}
+	}
+
+	counters_.emplace_back(new Counter(name, system));
+	return counters_.back().get();
+}
+
+void FrameStats::detach(System* system) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto&& counter : counters_)
+		if (counter->system_ == system)
+			counter->system_ = nullptr;
+}
+
+void FrameStats::endFrame() {
+	std::uint64_t now = MonotonicClock::ticks();
+	std::uint64_t frameTicks = 0;
+
+	std::vector<Overrun> overruns;
+	Counter* worst = nullptr;
+	std::string worstName;
+	std::uint64_t worstTicks = 0;
+	bool isSummaryDue = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		bool isFrame = frame_start_ != 0; // the time before the first frame boundary is no frame
+
+		if (isFrame) {
+			frameTicks = now - frame_start_;
+			frame_ticks_[frames_ % kHistory] = frameTicks;
+			++frames_;
+		}
+
+		frame_start_ = now;
+
+		for (auto&& counter : counters_) {
+			std::uint64_t ticks = counter->frame_ticks_.exchange(0, std::memory_order_relaxed);
+			if (!isFrame)
+				continue;
+
+			counter->last_ticks_ = ticks;
+			counter->total_ticks_ += ticks;
+			counter->max_ticks_ = std::max(counter->max_ticks_, ticks);
+			++counter->frames_;
+
+			std::int64_t budget = counter->system_ ?
+				counter->system_->getBudget().count() :
+				counter->budget_us_.load(std::memory_order_relaxed);
+
+			if (budget > 0 && microseconds(ticks) > budget) {
+				++counter->overruns_;
+				overruns.push_back(Overrun{ counter->system_, counter->name_, ticks, budget });
+			}
+
+			if (!worst || ticks > worst->last_ticks_)
+				worst = counter.get();
+		}
+
+		if (worst) {
+			worstName = worst->name_;
+			worstTicks = worst->last_ticks_;
+		}
+
+		auto interval = summary_interval_s_.load(std::memory_order_relaxed);
+		if (interval > 0 && MonotonicClock::toDuration(now - last_summary_) >= std::chrono::seconds(interval)) {
+			last_summary_ = now;
+			isSummaryDue = true;
+		}
+	}
+
+	// report without holding the mutex, handlers may well look at the stats
+	for (auto&& overrun : overruns) {
+		auto cost = std::chrono::microseconds(microseconds(overrun.ticks_));
+
+		if (overrun.system_)
+			overrun.system_->budgetExceeded(cost);
+		else
+			gLogLimited(EWarning, 5) << overrun.name_ << " took " << milliseconds(overrun.ticks_)
+				<< " ms, its budget is " << overrun.budget_us_ / 1000.0 << " ms";
+	}
+
+	auto frameBudget = frame_budget_us_.load(std::memory_order_relaxed);
+	if (frameBudget > 0 && microseconds(frameTicks) > frameBudget) {
+		if (worst)
+			gLogLimited(EWarning, 5) << "Frame took " << milliseconds(frameTicks) << " ms (budget " << frameBudget / 1000.0
+				<< " ms), most expensive: " << worstName << " with " << milliseconds(worstTicks) << " ms";
+		else
+			gLogLimited(EWarning, 5) << "Frame took " << milliseconds(frameTicks) << " ms (budget " << frameBudget / 1000.0 << " ms)";
+	}
+
+	if (isSummaryDue)
+		logSummary(snapshot());
+}
+
+void FrameStats::setFrameBudget(std::chrono::microseconds budget) {
+	frame_budget_us_.store(budget.count(), std::memory_order_relaxed);
+}
+
+void FrameStats::setSummaryInterval(std::chrono::seconds interval) {
+	summary_interval_s_.store(interval.count(), std::memory_order_relaxed);
+}
+
+FrameStats::Snapshot FrameStats::snapshot() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Snapshot result = {};
+	result.frames_ = frames_;
+
+	std::vector<std::uint64_t> history(frame_ticks_.begin(), frame_ticks_.begin() + std::min<std::uint64_t>(frames_, kHistory));
+	if (!history.empty()) {
+		std::sort(history.begin(), history.end());
+
+		// nearest rank: the smallest value at least the given fraction of the frames are not slower than
+		auto at = [&history](double percentile) {
+			size_t rank = static_cast<size_t>(std::ceil(percentile * history.size()));
+			return milliseconds(history[std::min(std::max<size_t>(rank, 1), history.size()) - 1]);
+		};
+
+		result.p50_ms_ = at(0.5);
+		result.p95_ms_ = at(0.95);
+		result.p99_ms_ = at(0.99);
+		result.max_ms_ = milliseconds(history.back());
+	}
+
+	for (auto&& counter : counters_) {
+		Entry entry;
+		entry.name_ = counter->name_;
+		entry.last_ms_ = milliseconds(counter->last_ticks_);
+		entry.average_ms_ = counter->frames_ ? milliseconds(counter->total_ticks_) / counter->frames_ : 0.0;
+		entry.max_ms_ = milliseconds(counter->max_ticks_);
+		entry.budget_ms_ = (counter->system_ ?
+			counter->system_->getBudget().count() :
+			counter->budget_us_.load(std::memory_order_relaxed)) / 1000.0;
+		entry.overruns_ = counter->overruns_;
+
+		result.entries_.push_back(std::move(entry));
+	}
+
+	std::sort(result.entries_.begin(), result.entries_.end(), [](const Entry& a, const Entry& b) {
+		return a.average_ms_ > b.average_ms_;
+	});
+
+	return result;
+}
+
+void FrameStats::reset() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	frames_ = 0;
+	frame_start_ = 0;
+
+	for (auto&& counter : counters_) {
+		counter->frame_ticks_.store(0, std::memory_order_relaxed);
+		counter->last_ticks_ = 0;
+		counter->total_ticks_ = 0;
+		counter->max_ticks_ = 0;
+		counter->frames_ = 0;
+		counter->overruns_ = 0;
+	}
+}
+
+void FrameStats::logSummary(const Snapshot& snapshot) const {
+	std::ostringstream summary;
+	summary << std::fixed << std::setprecision(2)
+		<< "Frame time p50 " << snapshot.p50_ms_
+		<< " ms, p95 " << snapshot.p95_ms_
+		<< " ms, p99 " << snapshot.p99_ms_
+		<< " ms, max " << snapshot.max_ms_ << " ms";
+
+	for (size_t i = 0; i < std::min<size_t>(snapshot.entries_.size(), 5); ++i) {
+		const Entry& entry = snapshot.entries_[i];
+		summary << (i == 0 ? "; " : ", ") << entry.name_ << " " << entry.average_ms_ << " ms";
+
+		if (entry.overruns_ > 0)
+			summary << " (" << entry.overruns_ << " over budget)";
+	}
+
+	gLog << summary.str();
+}
+
+FURRY_NS_END
@@ -19,17 +19,49 @@ FURRY_NS_BEGIN
 
 GLFWApplication* GLFWApplication::instance_ = nullptr;
 
-GLFWApplication::GLFWApplication(const Args &args, const Config &config, std::string name) : Application(name) {
+GLFWApplication::GLFWApplication(const Args &args, const Config &config, std::string name) :
+	Application(name),
+	update_cost_(nullptr),
+	render_cost_(nullptr)
+{
 	config_ = config;
 	instance_ = this;
+	subscribeInput();
 }
-GLFWApplication::GLFWApplication(const Args &args, std::string name) : Application(name) {
+GLFWApplication::GLFWApplication(const Args &args, std::string name) :
+	Application(name),
+	update_cost_(nullptr),
+	render_cost_(nullptr)
+{
 	config_ = Config();
 	instance_ = this;
+	subscribeInput();
 }
-GLFWApplication::GLFWApplication(std::string name) : Application(name) {
+GLFWApplication::GLFWApplication(std::string name) :
+	Application(name),
+	update_cost_(nullptr),
+	render_cost_(nullptr)
+{
 	config_ = Config();
 	instance_ = this;
+	subscribeInput();
+}
+
+GLFWApplication::~GLFWApplication() {
+	Channel::remove<KeyInput>(this);
+	Channel::remove<MouseButtonInput>(this);
+	Channel::remove<MouseMoveInput>(this);
+	Channel::remove<MouseScrollInput>(this);
+
+	if (instance_ == this)
+		instance_ = nullptr;
+}
+
+void GLFWApplication::subscribeInput() {
+	Channel::add<KeyInput>(this);
+	Channel::add<MouseButtonInput>(this);
+	Channel::add<MouseMoveInput>(this);
+	Channel::add<MouseScrollInput>(this);
 }
 
 bool GLFWApplication::initializeDependencies() {
@@ -102,10 +134,25 @@ void GLFWApplication::update() {
 	static Timer timer(true);
 	double elapsed = timer.elapsed().count() / 1000.0;
 
-	update(elapsed);
-	render(elapsed);
+	if (engine_ && !update_cost_) {
+		update_cost_ = engine_->frameStats().counter(getName() + " update");
+		render_cost_ = engine_->frameStats().counter(getName() + " render");
+	}
 
-	swapBuffers();
+	{
+		FURRY_PROFILE_ZONE("GLFWApplication::update");
+		FrameStats::Scope scope(update_cost_);
+		update(elapsed);
+	}
+	{
+		FURRY_PROFILE_ZONE("GLFWApplication::render");
+		FrameStats::Scope scope(render_cost_);
+		render(elapsed);
+	}
+	{
+		FURRY_PROFILE_ZONE("GLFWApplication::swapBuffers");
+		swapBuffers();
+	}
 }
 
 void GLFWApplication::swapBuffers() {
@@ -119,40 +166,57 @@ void GLFWApplication::clear(float r, float g, float b, float a) {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void GLFWApplication::glfwKeyEvent(GLFWwindow *window, int key, int scancode, int action, int mods) {
-	KeyboardEvent e(static_cast<KeyboardEvent::Key_US>(key), 
-					static_cast<InputEvent::Modifiers>(mods));
-	switch (action) {
+void GLFWApplication::operator()(const KeyInput& input) {
+	KeyboardEvent e(static_cast<KeyboardEvent::Key_US>(input.key_), 
+					static_cast<InputEvent::Modifiers>(input.mods_));
+	switch (input.action_) {
 	case GLFW_PRESS:
-		instance_->keyPressEvent(e);
+		keyPressEvent(e);
 		break;
 	case GLFW_RELEASE:
-		instance_->keyReleaseEvent(e);
+		keyReleaseEvent(e);
 		break;
 	default:
-		instance_->keyPressEvent(e);
+		keyPressEvent(e);
 	}
 }
 
-void GLFWApplication::glfwMouseEvent(GLFWwindow *window, int button, int action, int mods) {
-	MouseEvent e(static_cast<MouseEvent::Button>(button),
-		static_cast<InputEvent::Modifiers>(mods));
-	switch (action) {
+void GLFWApplication::operator()(const MouseButtonInput& input) {
+	MouseEvent e(static_cast<MouseEvent::Button>(input.button_),
+		static_cast<InputEvent::Modifiers>(input.mods_));
+	switch (input.action_) {
 	case GLFW_PRESS:
-		instance_->mousePressEvent(e);
+		mousePressEvent(e);
 		break;
 	case GLFW_RELEASE:
-		instance_->mouseReleaseEvent(e);
+		mouseReleaseEvent(e);
 		break;
 	default:
-		instance_->mousePressEvent(e);
+		mousePressEvent(e);
 	}
 }
+
+void GLFWApplication::operator()(const MouseMoveInput& input) {
+	mouseMoveEvent(input.x_, input.y_);
+}
+
+void GLFWApplication::operator()(const MouseScrollInput& input) {
+	scrollEvent(input.x_, input.y_);
+}
+
+// the GLFW callbacks only translate into Channel events, so recorders and replayers see the same input as the application
+void GLFWApplication::glfwKeyEvent(GLFWwindow *window, int key, int scancode, int action, int mods) {
+	Channel::broadcast(KeyInput{ key, scancode, action, mods });
+}
+
+void GLFWApplication::glfwMouseEvent(GLFWwindow *window, int button, int action, int mods) {
+	Channel::broadcast(MouseButtonInput{ button, action, mods });
+}
 void GLFWApplication::glfwMouseMoveEvent(GLFWwindow *window, double x, double y) { //position
-	instance_->mouseMoveEvent(x, y);
+	Channel::broadcast(MouseMoveInput{ x, y });
 }
 void GLFWApplication::glfwMouseScrollEvent(GLFWwindow *window, double x, double y) { //offset
-	instance_->scrollEvent(x, y);
+	Channel::broadcast(MouseScrollInput{ x, y });
 }
 
 FURRY_NS_END
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+FURRY_NS_BEGIN
+
+Lane::Lane() : active_(nullptr), is_drain_scheduled_(false) {
+}
+
+Lane::Lane(Active& active) : active_(&active), is_drain_scheduled_(false) {
+}
+
+Lane& Lane::main() {
+	static Lane mainLane;
+	return mainLane;
+}
+
+void Lane::send(Callback message) {
+	mailbox_.push(std::move(message));
+
+	// wake up the Active only once per burst of messages
+	if (active_ && !is_drain_scheduled_.exchange(true)) {
+		active_->send([this] {
+			is_drain_scheduled_.store(false);
+			drain();
+		});
+	}
+}
+
+size_t Lane::drain() {
+	size_t count = 0;
+	Callback cb;
+
+	while (mailbox_.try_pop(cb)) {
+		cb();
+		++count;
+	}
+
+	return count;
+}
+
+FURRY_NS_END
@@ -0,0 +1,299 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+FURRY_NS_BEGIN
+
+namespace {
+	// owns the ring of the current thread; the backend frees it once it is drained
+	struct RingHolder {
+		RingHolder() : ring_(new LogRing), is_registered_(false) {}
+		~RingHolder() {
+			ring_->orphan();
+		}
+
+		LogRing* ring_;
+		bool is_registered_;
+	};
+}
+
+/*** LogRing ***/
+LogRing::LogRing() :
+	records_(new LogRecord[kCapacity]),
+	head_(0),
+	tail_(0),
+	dropped_(0),
+	is_orphaned_(false)
+{
+}
+
+LogRing::~LogRing() {
+	delete[] records_;
+}
+
+bool LogRing::tryPush(const LogRecord& record) {
+	std::uint64_t head = head_.load(std::memory_order_relaxed);
+
+	if (head - tail_.load(std::memory_order_acquire) >= kCapacity) {
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// only copy the part of the text that is actually used
+	LogRecord& slot = records_[head & (kCapacity - 1)];
+	std::memcpy(&slot, &record, offsetof(LogRecord, text_) + record.length_);
+
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+/*** LogBackend ***/
+LogBackend::LogBackend() : is_running_(true) {
+	thread_ = std::thread(&LogBackend::run, this);
+}
+
+LogBackend::~LogBackend() {
+	is_running_.store(false);
+	thread_.join();
+
+	drain();
+
+	for (auto ring : rings_)
+		if (ring->isOrphaned())
+			delete ring;
+}
+
+LogBackend& LogBackend::instance() {
+	// the destructor drains into the Logger's sinks, so the Logger has to be constructed
+	// first (statics are destroyed in reverse order)
+	Logger::instance();
+
+	static LogBackend backend;
+	return backend;
+}
+
+LogRing& LogBackend::localRing() {
+	static thread_local RingHolder holder;
+
+	if (!holder.is_registered_) {
+		instance().registerRing(holder.ring_);
+		holder.is_registered_ = true;
+	}
+
+	return *holder.ring_;
+}
+
+void LogBackend::push(const LogRecord& record) {
+	localRing().tryPush(record);
+}
+
+void LogBackend::registerRing(LogRing* ring) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	rings_.push_back(ring);
+}
+
+void LogBackend::drain() {
+	drainOnce();
+}
+
+size_t LogBackend::drainOnce() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto sinks = Logger::instance().sinks_.read(); // one snapshot for the whole pass
+	size_t count = 0;
+
+	for (auto it = rings_.begin(); it != rings_.end();) {
+		LogRing* ring = *it;
+		bool isOrphaned = ring->isOrphaned(); // read before draining, so nothing pushed before the thread exited is lost
+
+		count += ring->consume([&sinks](const LogRecord& record) {
+			LogMessage::Meta meta = { record.level_, record.file_, record.line_, record.timestamp_ };
+			std::string message;
+			bool isFormatted = false;
+
+			for (auto&& sink : *sinks) {
+				if (sink.isBinary()) {
+					sink.forward(record);
+					continue;
+				}
+
+				if (!isFormatted) { // at most once per record, and only if a text sink wants it
+					message = record.descriptor_ ?
+						formatLogArguments(record.descriptor_->format_, record.text_, record.length_) :
+						std::string(record.text_, record.length_);
+					isFormatted = true;
+				}
+
+				sink.forward(meta, message);
+			}
+		});
+
+		if (auto dropped = ring->takeDropped()) {
+			LogMessage::Meta meta = { LogLevel::EWarning, __FILE__, __LINE__, MonotonicClock::ticks() };
+			std::string message = std::to_string(dropped) + " log records dropped, ring was full";
+
+			for (auto&& sink : *sinks)
+				sink.forward(meta, message);
+		}
+
+		if (isOrphaned) {
+			delete ring;
+			it = rings_.erase(it);
+		}
+		else
+			++it;
+	}
+
+	return count;
+}
+
+void LogBackend::run() {
+	while (is_running_.load()) {
+		if (drainOnce() == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+/*** LogRecordStream ***/
+LogRecordStream::LogRecordStream(LogLevel level, const char* file, int line) : is_active_(logLevel(level)) {
+	record_.timestamp_ = MonotonicClock::ticks();
+	record_.descriptor_ = nullptr;
+	record_.file_ = file;
+	record_.line_ = line;
+	record_.level_ = level;
+	record_.length_ = 0;
+}
+
+LogRecordStream::LogRecordStream(LogRecordStream&& other) : record_(other.record_), is_active_(other.is_active_) {
+	other.record_.file_ = nullptr; // marks the moved-from stream
+	other.is_active_ = false;
+}
+
+LogRecordStream::~LogRecordStream() {
+	if (!record_.file_)
+		return;
+
+	if (FlightRecorder::isEnabled())
+		FlightRecorder::record(record_);
+
+	if (is_active_)
+		LogBackend::push(record_);
+}
+
+void LogRecordStream::append(const char* data, size_t size) {
+	size_t available = LogRecord::kTextCapacity - record_.length_;
+
+	if (size > available)
+		size = available; // truncated
+
+	std::memcpy(record_.text_ + record_.length_, data, size);
+	record_.length_ += static_cast<std::uint16_t>(size);
+}
+
+LogRecordStream& LogRecordStream::operator << (const char* str) {
+	append(str, std::strlen(str));
+	return *this;
+}
+
+LogRecordStream& LogRecordStream::operator << (const std::string& str) {
+	append(str.data(), str.size());
+	return *this;
+}
+
+LogRecordStream& LogRecordStream::operator << (char c) {
+	append(&c, 1);
+	return *this;
+}
+
+LogRecordStream& LogRecordStream::operator << (bool b) {
+	return *this << (b ? "true" : "false");
+}
+
+LogRecordStream& LogRecordStream::operator << (short i) {
+	return *this << static_cast<long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (unsigned short i) {
+	return *this << static_cast<unsigned long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (int i) {
+	return *this << static_cast<long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (unsigned int i) {
+	return *this << static_cast<unsigned long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (long i) {
+	return *this << static_cast<long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (unsigned long i) {
+	return *this << static_cast<unsigned long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (long long i) {
+	if (i < 0) {
+		append("-", 1);
+		return *this << (0ull - static_cast<unsigned long long>(i));
+	}
+
+	return *this << static_cast<unsigned long long>(i);
+}
+
+LogRecordStream& LogRecordStream::operator << (unsigned long long i) {
+	char buffer[24];
+	char* end = buffer + sizeof(buffer);
+	char* begin = end;
+
+	do {
+		*--begin = static_cast<char>('0' + (i % 10));
+		i /= 10;
+	} while (i);
+
+	append(begin, end - begin);
+	return *this;
+}
+
+LogRecordStream& LogRecordStream::operator << (float f) {
+	return *this << static_cast<double>(f);
+}
+
+LogRecordStream& LogRecordStream::operator << (double d) {
+	char buffer[32];
+	int length = std::snprintf(buffer, sizeof(buffer), "%g", d);
+
+	if (length > 0)
+		append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+
+	return *this;
+}
+
+LogRecordStream& LogRecordStream::operator << (const void* p) {
+	char buffer[24];
+	int length = std::snprintf(buffer, sizeof(buffer), "%p", p);
+
+	if (length > 0)
+		append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+
+	return *this;
+}
+
+FURRY_NS_END
@@ -14,14 +14,69 @@
 */
 
 #include <furry2d/furry2d.h>
+#include <chrono>
+#include <thread>
 
 FURRY_NS_BEGIN
 
-Logger::Logger(const std::string& filename) {
+namespace {
+	// the sites that suppressed messages at least once
+	struct SiteLimits {
+		std::mutex mutex_;
+		std::vector<LogSiteLimit*> limits_;
+	};
+
+	SiteLimits& siteLimits() {
+		static SiteLimits instance;
+		return instance;
+	}
+
+	const std::uint64_t kSiteWindow = 1000; // milliseconds
+
+	// never 0, which marks a site that has not opened a window yet
+	std::uint64_t siteMilliseconds() {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			MonotonicClock::toDuration(MonotonicClock::ticks())).count()) + 1;
+	}
+}
+
+const std::chrono::milliseconds Logger::kPollInterval(100);
+
+Logger::Logger(const std::string& filename) : Logger(filename, false) {
+}
+
+Logger::Logger(const std::string& filename, bool isGlobal) :
+	policy_(LogBackpressure::Drop),
+	max_pending_(16 * 1024),
+	sample_rate_(16),
+	pending_(0),
+	dropped_(0),
+	sampled_(0),
+	is_global_(isGlobal),
+	is_stopping_(false)
+{
+	if (is_global_)
+		siteLimits(); // destroyed after this Logger, which reports from it until the end
+
 	active_ = Active::create();
 
 	add(makeConsoleSink());
 	add(makeFileSink(filename));
+
+	poller_ = std::thread(&Logger::poll, this);
+}
+
+Logger::~Logger() {
+	{
+		std::lock_guard<std::mutex> lock(poller_mutex_);
+		is_stopping_ = true;
+	}
+
+	poller_wakeup_.notify_one();
+	poller_.join();
+
+	if (is_global_)
+		LogSiteLimit::reportSuppressed(*this, true);
 }
 
 LogMessage Logger::operator()(
@@ -38,19 +93,25 @@ LogMessage Logger::operator()(
 }
 
 void Logger::add(const LogSink& sink) {
-	sinks_.push_back(sink); // perhaps check for duplicates?
+	sinks_.update([&sink](SinkList& sinks) {
+		sinks.push_back(sink); // perhaps check for duplicates?
+	});
 }
 
 void Logger::remove(const LogSink& sink) {
-	auto it = std::find(sinks_.begin(), sinks_.end(), sink);
+	sinks_.update([&sink](SinkList& sinks) {
+		auto it = std::find(sinks.begin(), sinks.end(), sink);
 
-	if (it == sinks_.end())
-		throw std::runtime_error("Tried to remove a sink that was not added yet");
+		if (it == sinks.end())
+			throw std::runtime_error("Tried to remove a sink that was not added yet");
 
-	sinks_.erase(it);
+		sinks.erase(it);
+	});
 }
 
 void Logger::flush(const LogMessage& message) const {
+	FURRY_PROFILE_ZONE("Logger::flush");
+
 	/*
 	// This is the single-threaded version
 	auto msg = message.buffer_.str();
@@ -61,14 +122,150 @@ void Logger::flush(const LogMessage& message) const {
 
 	// This is the Active Object (and threadsafe) version
 
-	auto&& sinks = sinks_;
+	size_t maxPending = max_pending_.load(std::memory_order_relaxed);
+
+	if (maxPending > 0 && message.meta_.level_ != LogLevel::EFatal) {
+		switch (policy_.load(std::memory_order_relaxed)) {
+		case LogBackpressure::Drop:
+			if (pending_.load(std::memory_order_relaxed) >= maxPending) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			break;
+
+		case LogBackpressure::Block:
+			// a sink that logs would wait for itself, as nobody else drains the queue
+			if (!active_->isCurrentThread()) {
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+
+				while (pending_.load(std::memory_order_relaxed) >= maxPending && std::chrono::steady_clock::now() < deadline)
+					std::this_thread::yield();
+			}
+
+			if (pending_.load(std::memory_order_relaxed) >= maxPending) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			break;
+
+		case LogBackpressure::Sample:
+			if (pending_.load(std::memory_order_relaxed) >= maxPending &&
+				sampled_.fetch_add(1, std::memory_order_relaxed) % sample_rate_.load(std::memory_order_relaxed) != 0) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			break;
+		}
+	}
+
+	auto sinks = sinks_.share(); // the snapshot that is current now, shared instead of copied
 	auto&& meta = message.meta_;
 	auto msg = message.buffer_.str();
 
+	pending_.fetch_add(1, std::memory_order_relaxed);
+
 	active_->send([=] {
-		for (auto&& sink : sinks)
+		for (auto&& sink : *sinks)
 			sink.forward(meta, msg);
+
+		// report drops once the queue has drained
+		if (pending_.fetch_sub(1, std::memory_order_relaxed) == 1) {
+			if (auto dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+				LogMessage::Meta warning = { LogLevel::EWarning, __FILE__, __LINE__, MonotonicClock::ticks() };
+				std::string text = std::to_string(dropped) + " log messages dropped, the queue was full";
+
+				auto current = sinks_.read(); // named, a temporary guard would end before the loop
+				for (auto&& sink : *current)
+					sink.forward(warning, text);
+			}
+		}
 	});
 }
 
+void Logger::setBackpressure(LogBackpressure policy, size_t maxPending, std::uint32_t sampleRate) {
+	policy_.store(policy);
+	max_pending_.store(maxPending);
+	sample_rate_.store(std::max<std::uint32_t>(sampleRate, 1));
+}
+
+void Logger::poll() {
+	std::unique_lock<std::mutex> lock(poller_mutex_);
+
+	while (!poller_wakeup_.wait_for(lock, kPollInterval, [this] { return is_stopping_; })) {
+		// on the sinks' thread, so sinks need no extra synchronization for it
+		active_->send([this] {
+			auto sinks = sinks_.read(); // named, a temporary guard would end before the loop
+			for (auto&& sink : *sinks)
+				sink.poll();
+		});
+
+		if (is_global_)
+			LogSiteLimit::reportSuppressed(*this, false);
+	}
+}
+
+/*** LogSiteLimit ***/
+bool LogSiteLimit::allow(std::uint32_t perSecond, LogLevel level, const char* file, int line) {
+	const std::uint64_t kCountMask = (1ull << kCountBits) - 1;
+
+	std::uint64_t now = siteMilliseconds();
+	std::uint64_t budget = std::min<std::uint64_t>(perSecond, kCountMask);
+	std::uint64_t state = state_.load(std::memory_order_relaxed);
+
+	for (;;) {
+		// window and count change together, so no message is counted against the wrong window
+		std::uint64_t start = state >> kCountBits;
+		bool isOpen = start != 0 && now - start < kSiteWindow;
+		std::uint64_t count = isOpen ? (state & kCountMask) : 0;
+
+		if (count >= budget)
+			break;
+
+		if (state_.compare_exchange_weak(state, ((isOpen ? start : now) << kCountBits) | (count + 1), std::memory_order_relaxed)) {
+			// whoever opens the next window reports what was skipped in the last one
+			if (!isOpen) {
+				if (auto suppressed = suppressed_.exchange(0, std::memory_order_relaxed))
+					Logger::instance()(level, file, line) << "(" << suppressed << " similar messages suppressed)";
+			}
+
+			return true;
+		}
+	}
+
+	suppressed_.fetch_add(1, std::memory_order_relaxed);
+
+	// from now on the Logger reports for this site as well, in case it stays quiet
+	if (!is_listed_.load(std::memory_order_acquire)) {
+		SiteLimits& sites = siteLimits();
+		std::lock_guard<std::mutex> lock(sites.mutex_);
+
+		if (!is_listed_.load(std::memory_order_relaxed)) {
+			level_ = level;
+			file_ = file;
+			line_ = line;
+			sites.limits_.push_back(this);
+			is_listed_.store(true, std::memory_order_release);
+		}
+	}
+
+	return false;
+}
+
+void LogSiteLimit::reportSuppressed(Logger& logger, bool isFinal) {
+	std::uint64_t now = siteMilliseconds();
+
+	SiteLimits& sites = siteLimits();
+	std::lock_guard<std::mutex> lock(sites.mutex_);
+
+	for (auto limit : sites.limits_) {
+		std::uint64_t start = limit->state_.load(std::memory_order_relaxed) >> kCountBits;
+
+		if (!isFinal && start != 0 && now - start < kSiteWindow)
+			continue; // still counting, maybe the site reports itself when it opens the next window
+
+		if (auto suppressed = limit->suppressed_.exchange(0, std::memory_order_relaxed))
+			logger(limit->level_, limit->file_, limit->line_) << "(" << suppressed << " similar messages suppressed)";
+	}
+}
+
 FURRY_NS_END
\ No newline at end of file
@@ -14,7 +14,10 @@
 */
 
 #include <furry2d/furry2d.h>
+#include <algorithm>
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 FURRY_NS_BEGIN
 
@@ -50,4 +53,48 @@ bool logLevel(LogLevel level) {
 	return gLogLevelState[lvl].load(std::memory_order_acquire);
 }
 
+namespace {
+	struct ModuleRegistry {
+		std::mutex mutex_;
+		std::vector<LogModule*> modules_;
+	};
+
+	ModuleRegistry& moduleRegistry() {
+		static ModuleRegistry registry;
+		return registry;
+	}
+}
+
+LogModule LogModule::global_("global");
+
+LogModule::LogModule(const char* name, LogLevel threshold) :
+	name_(name),
+	threshold_(static_cast<int>(threshold))
+{
+	auto& registry = moduleRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+	registry.modules_.push_back(this);
+}
+
+LogModule::~LogModule() {
+	auto& registry = moduleRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+
+	registry.modules_.erase(
+		std::remove(registry.modules_.begin(), registry.modules_.end(), this),
+		registry.modules_.end()
+	);
+}
+
+LogModule* LogModule::find(const std::string& name) {
+	auto& registry = moduleRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+
+	for (auto module : registry.modules_)
+		if (name == module->name())
+			return module;
+
+	return nullptr;
+}
+
 FURRY_NS_END
\ No newline at end of file
@@ -22,11 +22,19 @@ LogMessage::LogMessage( LogLevel level,
 						const std::string& file,
 						int line,
 						Logger* owner) : owner_(owner) {
-	meta_ = { level, file, line };
+	meta_ = { level, file, line, MonotonicClock::ticks() };
 }
 
 LogMessage::~LogMessage() {
-	if (owner_ && logLevel(meta_.level_))
+	if (!owner_)
+		return;
+
+	if (FlightRecorder::isEnabled()) { // also sees the levels that are disabled for the sinks
+		auto text = buffer_.str();
+		FlightRecorder::record(meta_.level_, meta_.file_.c_str(), meta_.line_, text.data(), text.size(), meta_.timestamp_);
+	}
+
+	if (logLevel(meta_.level_))
 		owner_->flush(*this);
 }
 
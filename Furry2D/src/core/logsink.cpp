@@ -18,16 +18,30 @@
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+#ifdef FURRY_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
 
 FURRY_NS_BEGIN
 
 LogSink::LogSink(const LogSink& sink) :
-wrapper_(sink.wrapper_->clone())
+wrapper_(sink.wrapper_)
 {
 }
 
 LogSink& LogSink::operator = (const LogSink& sink) FURRY_NOEXCEPT {
-	wrapper_.reset(sink.wrapper_->clone());
+	wrapper_ = sink.wrapper_;
 	return *this;
 }
 
@@ -42,18 +56,43 @@ void LogSink::forward(
 	wrapper_->forward(meta, message);
 }
 
-std::ostream& operator<< (std::ostream& os, const LogLevel& level) {
-	switch (level) {
-	case LogLevel::EDebug:		os << "[dbg] ";		break;
-	case LogLevel::EMessage:	os << "      ";		break;
-	case LogLevel::EWarning:	os << ">wrn< ";		break;
-	case LogLevel::EError:		os << "< ERROR >      ";	break;	// extra noticable
-	case LogLevel::EFatal:		os << ">>>>FATAL<<<<  ";	break;	// extra noticable
-	default:
-		os << "Unknown";
+bool LogSink::isBinary() const {
+	return wrapper_->isBinary();
+}
+
+void LogSink::forward(const LogRecord& record) const {
+	wrapper_->forward(record);
+}
+
+void LogSink::poll() const {
+	wrapper_->poll();
+}
+
+namespace {
+	const char* levelPrefix(LogLevel level) {
+		switch (level) {
+		case LogLevel::EDebug:		return "[dbg] ";
+		case LogLevel::EMessage:	return "      ";
+		case LogLevel::EWarning:	return ">wrn< ";
+		case LogLevel::EError:		return "< ERROR >      ";	// extra noticable
+		case LogLevel::EFatal:		return ">>>>FATAL<<<<  ";	// extra noticable
+		default:
+			return "Unknown";
+		}
+	}
+
+	// a message's MonotonicClock timestamp, or the current time if it has none
+	std::uint64_t ticksOf(std::uint64_t timestamp) {
+		return timestamp ? timestamp : MonotonicClock::ticks();
+	}
+
+	std::uint64_t nanosecondsSinceEpoch(std::uint64_t timestamp) {
+		return static_cast<std::uint64_t>(MonotonicClock::sinceEpoch(ticksOf(timestamp)).count());
 	}
+}
 
-	return os;
+std::ostream& operator<< (std::ostream& os, const LogLevel& level) {
+	return os << levelPrefix(level);
 }
 
 LogSink makeConsoleSink() {
@@ -69,49 +108,465 @@ LogSink makeConsoleSink() {
 	};
 }
 namespace {
-	struct FileSink {
-		FileSink(const std::string& filename) :
-		file_(std::make_shared<std::ofstream>(filename))
+	// formats messages as "[HH:MM:SS] <level>message (file:line)\n", not thread-safe
+	class LineFormatter {
+	public:
+		LineFormatter() : cached_second_(-1) {}
+
+		void append(std::string& out, const LogMessage::Meta& meta, const std::string& message) {
+			using namespace std::chrono;
+
+			char line[16];
+			int length = std::snprintf(line, sizeof(line), "%d", meta.line_);
+
+			// the time the message was logged, not the time it is written
+			out.append(timestamp(system_clock::to_time_t(MonotonicClock::toSystemTime(ticksOf(meta.timestamp_)))));
+			out.append(levelPrefix(meta.level_));
+			out.append(message);
+			out.append(" (");
+			out.append(meta.file_);
+			out.push_back(':');
+			out.append(line, std::max(length, 0));
+			out.append(")\n");
+		}
+
+	private:
+		// "[HH:MM:SS] " of the given second
+		const char* timestamp(std::time_t seconds) {
+			if (seconds != cached_second_) {
+#ifdef FURRY_COMPILER_VC
+				tm lt;
+				localtime_s(&lt, &seconds);
+				auto local_time = &lt;
+#else
+				tm lt;
+				auto local_time = localtime_r(&seconds, &lt);
+#endif
+				std::strftime(cached_timestamp_, sizeof(cached_timestamp_), "[%H:%M:%S] ", local_time);
+				cached_second_ = seconds;
+			}
+
+			return cached_timestamp_;
+		}
+
+		std::time_t cached_second_; // localtime is only called once per second
+		char cached_timestamp_[16];
+	};
+
+	class FileSink {
+	public:
+		FileSink(const std::string& filename, const FileSinkOptions& options) :
+			state_(std::make_shared<State>())
 		{
-			if (!file_->good()) {
+			state_->filename_ = filename;
+			state_->options_ = options;
+			state_->buffer_.reserve(options.buffer_size_);
+
+			open();
+		}
+
+		void operator()(
+			const LogMessage::Meta& meta,
+			const std::string& message
+			) const {
+			auto now = std::chrono::system_clock::now();
+			const FileSinkOptions& options = state_->options_;
+
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+
+			std::string& buffer = state_->buffer_;
+			state_->formatter_.append(buffer, meta, message);
+
+			if (buffer.size() >= options.buffer_size_ ||
+				meta.level_ >= options.flush_level_ ||
+				now - state_->last_flush_ >= options.flush_interval_)
+				flush(now);
+		}
+
+		// also writes out a buffer that no later message would flush
+		void poll() const {
+			auto now = std::chrono::system_clock::now();
+
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+
+			if (!state_->buffer_.empty() && now - state_->last_flush_ >= state_->options_.flush_interval_)
+				flush(now);
+		}
+
+	private:
+		struct State {
+			~State() {
+				if (!buffer_.empty())
+					file_.write(buffer_.data(), buffer_.size());
+			}
+
+			std::mutex mutex_; // the Logger's and the backend's thread both write here
+			std::string filename_;
+			FileSinkOptions options_;
+
+			std::ofstream file_;
+			std::uint64_t file_size_;
+			std::chrono::system_clock::time_point opened_;
+			std::chrono::system_clock::time_point last_flush_;
+
+			std::string buffer_;
+			LineFormatter formatter_;
+		};
+
+		// "game.log" -> "game.<index>.log"
+		std::string rotatedName(size_t index) const {
+			const std::string& filename = state_->filename_;
+			auto dot = filename.find_last_of('.');
+			auto slash = filename.find_last_of("/\\");
+
+			if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+				return filename + "." + std::to_string(index);
+
+			return filename.substr(0, dot) + "." + std::to_string(index) + filename.substr(dot);
+		}
+
+		void open() const {
+			state_->file_.open(state_->filename_, std::ios::binary | std::ios::trunc);
+
+			if (!state_->file_.good()) {
 				std::string message = "Failed to open file sink: ";
-				message.append(filename);
+				message.append(state_->filename_);
 				throw std::runtime_error(message);
 			}
+
+			state_->file_size_ = 0;
+			state_->opened_ = state_->last_flush_ = std::chrono::system_clock::now();
+		}
+
+		void rotate() const {
+			state_->file_.close();
+
+			size_t files = std::max<size_t>(state_->options_.max_files_, 1);
+
+			// the oldest one falls out, all others move up by one
+			std::remove(rotatedName(files - 1).c_str());
+
+			for (size_t i = files - 1; i > 1; --i)
+				std::rename(rotatedName(i - 1).c_str(), rotatedName(i).c_str());
+
+			if (files > 1)
+				std::rename(state_->filename_.c_str(), rotatedName(1).c_str());
+			else
+				std::remove(state_->filename_.c_str());
+
+			state_->file_.clear();
+			open();
+		}
+
+		void flush(std::chrono::system_clock::time_point now) const {
+			const FileSinkOptions& options = state_->options_;
+			std::string& buffer = state_->buffer_;
+
+			if ((options.max_file_size_ > 0 && state_->file_size_ > 0 && state_->file_size_ + buffer.size() > options.max_file_size_) ||
+				(options.max_file_age_.count() > 0 && now - state_->opened_ >= options.max_file_age_))
+				rotate();
+
+			state_->file_.write(buffer.data(), buffer.size());
+			state_->file_.flush();
+
+			state_->file_size_ += buffer.size();
+			state_->last_flush_ = now;
+			buffer.clear();
+		}
+
+		std::shared_ptr<State> state_;
+	};
+}
+
+FileSinkOptions::FileSinkOptions() :
+	buffer_size_(64 * 1024),
+	flush_interval_(1000),
+	flush_level_(LogLevel::EError),
+	max_file_size_(0),
+	max_file_age_(0),
+	max_files_(5)
+{
+}
+
+LogSink makeFileSink(const std::string& filename, const FileSinkOptions& options) {
+	return FileSink(filename, options);
+}
+
+namespace {
+	const char kCleanShutdownMarker[] = "--- log closed cleanly ---\n";
+
+	class MappedFileSink {
+	public:
+		MappedFileSink(const std::string& filename, size_t chunkSize) :
+			state_(std::make_shared<State>())
+		{
+			size_t granularity = State::granularity(); // mappings have to start at multiples of this
+			state_->chunk_size_ = std::max<size_t>((chunkSize + granularity - 1) / granularity * granularity, granularity);
+
+			if (!state_->open(filename))
+				throw std::runtime_error(std::string("Failed to open mapped file sink: ") + filename);
 		}
 
 		void operator()(
 			const LogMessage::Meta& meta,
 			const std::string& message
 			) const {
-			using namespace std::chrono;
+			std::lock_guard<std::mutex> lock(state_->mutex_);
 
-			auto now = system_clock::now();
-			auto time_t = system_clock::to_time_t(now);
-#ifdef FURRY_COMPILER_VC
-			tm lt;
-			localtime_s(&lt, &time_t);
-			auto local_time = &lt;
+			std::string& line = state_->line_; // reused, so formatting stops allocating after a while
+			line.clear();
+			state_->formatter_.append(line, meta, message);
+
+			state_->write(line.data(), line.size());
+		}
+
+	private:
+		// the file is mapped one chunk at a time, records are plain stores into the current chunk
+		struct State {
+			State() :
+#ifdef FURRY_PLATFORM_WINDOWS
+				file_(INVALID_HANDLE_VALUE),
+				mapping_(nullptr),
+#else
+				fd_(-1),
+#endif
+				view_(nullptr),
+				view_offset_(0),
+				position_(0),
+				written_(0),
+				is_failed_(false)
+			{
+			}
+
+			~State() {
+#ifdef FURRY_PLATFORM_WINDOWS
+				if (file_ == INVALID_HANDLE_VALUE)
+					return;
+#else
+				if (fd_ < 0)
+					return;
+#endif
+				// also after the first map() or a grow failed, only the marker is left out then
+				if (view_)
+					write(kCleanShutdownMarker, sizeof(kCleanShutdownMarker) - 1);
+
+				unmap();
+
+				// cut off the preallocated rest of the last chunk
+#ifdef FURRY_PLATFORM_WINDOWS
+				LARGE_INTEGER end;
+				end.QuadPart = static_cast<LONGLONG>(written_);
+				SetFilePointerEx(file_, end, nullptr, FILE_BEGIN);
+				SetEndOfFile(file_);
+				CloseHandle(file_);
+#else
+				if (ftruncate(fd_, static_cast<off_t>(written_)) != 0)
+					std::perror("Failed to truncate mapped log file");
+				::close(fd_);
+#endif
+			}
+
+			static size_t granularity() {
+#ifdef FURRY_PLATFORM_WINDOWS
+				SYSTEM_INFO info;
+				GetSystemInfo(&info);
+				return info.dwAllocationGranularity;
+#else
+				return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+			}
+
+			bool open(const std::string& filename) {
+#ifdef FURRY_PLATFORM_WINDOWS
+				file_ = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (file_ == INVALID_HANDLE_VALUE)
+					return false;
+#else
+				fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+				if (fd_ < 0)
+					return false;
+#endif
+				return map(0);
+			}
+
+			void write(const char* data, size_t size) {
+				while (size > 0 && !is_failed_) {
+					if (position_ == chunk_size_ && !map(view_offset_ + chunk_size_)) {
+						is_failed_ = true;
+						std::cerr << "Mapped file sink could not grow, further messages are lost\n";
+						return;
+					}
+
+					size_t chunk = std::min(size, chunk_size_ - position_);
+					std::memcpy(view_ + position_, data, chunk);
+
+					position_ += chunk;
+					written_ += chunk;
+					data += chunk;
+					size -= chunk;
+				}
+			}
+
+			// grows the file to offset + chunk_size_ and maps that chunk
+			bool map(std::uint64_t offset) {
+				unmap();
+
+				std::uint64_t size = offset + chunk_size_;
+#ifdef FURRY_PLATFORM_WINDOWS
+				mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+				if (!mapping_)
+					return false;
+
+				view_ = static_cast<char*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), chunk_size_));
+#else
+				if (ftruncate(fd_, static_cast<off_t>(size)) != 0)
+					return false;
+
+				void* view = mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(offset));
+				view_ = view == MAP_FAILED ? nullptr : static_cast<char*>(view);
+#endif
+				view_offset_ = offset;
+				position_ = 0;
+
+				return view_ != nullptr;
+			}
+
+			void unmap() {
+#ifdef FURRY_PLATFORM_WINDOWS
+				if (view_)
+					UnmapViewOfFile(view_);
+				if (mapping_)
+					CloseHandle(mapping_);
+				mapping_ = nullptr;
+#else
+				if (view_)
+					munmap(view_, chunk_size_);
+#endif
+				view_ = nullptr;
+			}
+
+			std::mutex mutex_; // the Logger's and the backend's thread both write here
+
+#ifdef FURRY_PLATFORM_WINDOWS
+			HANDLE file_;
+			HANDLE mapping_;
 #else
-			auto local_time = std::localtime(&time_t);
+			int fd_;
 #endif
-			(*file_)
-				<< std::put_time(local_time, "[%H:%M:%S] ")
-				<< meta.level_
-				<< message
-				<< " ("
-				<< meta.file_
-				<< ":"
-				<< meta.line_
-				<< ")\n";
-		}
-
-		std::shared_ptr<std::ofstream> file_;
+			char* view_;
+			size_t chunk_size_;
+			std::uint64_t view_offset_;	// of the current chunk in the file
+			size_t position_;			// within the current chunk
+			std::uint64_t written_;		// in total, the size the file is truncated to when closed
+			bool is_failed_;
+
+			LineFormatter formatter_;
+			std::string line_;
+		};
+
+		std::shared_ptr<State> state_;
+	};
+}
+
+LogSink makeMappedFileSink(const std::string& filename, size_t chunkSize) {
+	return MappedFileSink(filename, chunkSize);
+}
+
+namespace {
+	class BinaryFileSink {
+	public:
+		BinaryFileSink(const std::string& filename) :
+			state_(std::make_shared<State>())
+		{
+			state_->file_.open(filename, std::ios::binary);
+
+			if (!state_->file_.good()) {
+				std::string message = "Failed to open binary file sink: ";
+				message.append(filename);
+				throw std::runtime_error(message);
+			}
+
+			write(static_cast<std::uint32_t>(LogDecoder::kMagic));
+			write(static_cast<std::uint32_t>(LogDecoder::kVersion));
+		}
+
+		void operator()(
+			const LogMessage::Meta& meta,
+			const std::string& message
+			) const {
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+
+			write(static_cast<std::uint8_t>(LogDecoder::kText));
+			write(nanosecondsSinceEpoch(meta.timestamp_));
+			write(static_cast<std::uint8_t>(meta.level_));
+			write(static_cast<std::uint32_t>(meta.line_));
+			writeString<std::uint16_t>(meta.file_.data(), meta.file_.size());
+			writeString<std::uint32_t>(message.data(), message.size());
+		}
+
+		void operator()(const LogRecord& record) const {
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+
+			if (!record.descriptor_) { // plain text from the gFastLog macros
+				write(static_cast<std::uint8_t>(LogDecoder::kText));
+				write(nanosecondsSinceEpoch(record.timestamp_));
+				write(static_cast<std::uint8_t>(record.level_));
+				write(static_cast<std::uint32_t>(record.line_));
+				writeString<std::uint16_t>(record.file_, std::strlen(record.file_));
+				writeString<std::uint32_t>(record.text_, record.length_);
+				return;
+			}
+
+			auto id = reinterpret_cast<std::uintptr_t>(record.descriptor_);
+
+			// the static parts of a call site are written once per file
+			if (state_->written_.insert(record.descriptor_).second) {
+				const LogDescriptor& descriptor = *record.descriptor_;
+
+				write(static_cast<std::uint8_t>(LogDecoder::kDescriptor));
+				write(static_cast<std::uint64_t>(id));
+				write(static_cast<std::uint8_t>(descriptor.level_));
+				write(static_cast<std::uint32_t>(descriptor.line_));
+				writeString<std::uint16_t>(descriptor.file_, std::strlen(descriptor.file_));
+				writeString<std::uint16_t>(descriptor.format_, std::strlen(descriptor.format_));
+			}
+
+			write(static_cast<std::uint8_t>(LogDecoder::kRecord));
+			write(static_cast<std::uint64_t>(id));
+			write(nanosecondsSinceEpoch(record.timestamp_));
+			writeString<std::uint16_t>(record.text_, record.length_);
+		}
+
+		void poll() const {
+			std::lock_guard<std::mutex> lock(state_->mutex_);
+			state_->file_.flush();
+		}
+
+	private:
+		struct State {
+			std::mutex mutex_; // the Logger's and the backend's thread both write here
+			std::ofstream file_;
+			std::unordered_set<const LogDescriptor*> written_;
+		};
+
+		template <typename T>
+		void write(const T& value) const {
+			state_->file_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template <typename tLength>
+		void writeString(const char* data, size_t size) const {
+			size = std::min<size_t>(size, std::numeric_limits<tLength>::max());
+			write(static_cast<tLength>(size));
+			state_->file_.write(data, size);
+		}
+
+		std::shared_ptr<State> state_;
 	};
 }
 
-LogSink makeFileSink(const std::string& filename) {
-	return FileSink(filename);
+LogSink makeBinaryFileSink(const std::string& filename) {
+	return BinaryFileSink(filename);
 }
 
 FURRY_NS_END
\ No newline at end of file
@@ -0,0 +1,314 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+FURRY_NS_BEGIN
+
+namespace {
+	struct Event {
+		std::uint64_t ticks_;
+		const ProfileZone* zone_; // nullptr for the end of the innermost open zone
+	};
+
+	// single producer/single consumer ring of one thread's events, drained by the exporter
+	class ProfileBuffer {
+	public:
+		explicit ProfileBuffer(std::uint32_t id) :
+			events_(new Event[Profiler::kCapacity]),
+			head_(0),
+			tail_(0),
+			dropped_(0),
+			is_orphaned_(false),
+			depth_(0),
+			id_(id)
+		{
+		}
+
+		~ProfileBuffer() {
+			delete[] events_;
+		}
+
+		ProfileBuffer(const ProfileBuffer&) = delete;
+		ProfileBuffer& operator = (const ProfileBuffer&) = delete;
+
+		// producer only; keeps room for the ends of all open zones, so an end is never dropped
+		bool tryBegin(const ProfileZone& zone, std::uint64_t ticks) {
+			std::uint64_t head = head_.load(std::memory_order_relaxed);
+
+			if (head - tail_.load(std::memory_order_acquire) + depth_ + 2 > Profiler::kCapacity) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			push(head, &zone, ticks);
+			++depth_;
+			return true;
+		}
+
+		void end(std::uint64_t ticks) { // producer only
+			--depth_;
+			push(head_.load(std::memory_order_relaxed), nullptr, ticks);
+		}
+
+		template <typename tFunc>
+		void consume(tFunc func) { // consumer only
+			std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+			std::uint64_t head = head_.load(std::memory_order_acquire);
+
+			for (std::uint64_t i = tail; i != head; ++i)
+				func(events_[i & (Profiler::kCapacity - 1)]);
+
+			tail_.store(head, std::memory_order_release);
+		}
+
+		std::uint64_t takeDropped() {
+			return dropped_.exchange(0, std::memory_order_relaxed);
+		}
+
+		void orphan() { // the owning thread has exited
+			is_orphaned_.store(true, std::memory_order_release);
+		}
+
+		bool isOrphaned() const {
+			return is_orphaned_.load(std::memory_order_acquire);
+		}
+
+		std::uint32_t id() const {
+			return id_;
+		}
+
+		std::string name_; // guarded by the registry's mutex
+
+	private:
+		void push(std::uint64_t head, const ProfileZone* zone, std::uint64_t ticks) {
+			Event& event = events_[head & (Profiler::kCapacity - 1)];
+			event.ticks_ = ticks;
+			event.zone_ = zone;
+
+			head_.store(head + 1, std::memory_order_release);
+		}
+
+		Event* events_;
+		std::atomic<std::uint64_t> head_;
+		char padding_[64]; // keep producer and consumer indices on different cache lines
+		std::atomic<std::uint64_t> tail_;
+		std::atomic<std::uint64_t> dropped_;
+		std::atomic<bool> is_orphaned_;
+		std::uint32_t depth_; // producer only
+		std::uint32_t id_;
+	};
+
+	struct Registry {
+		Registry() : next_id_(1), origin_(MonotonicClock::ticks()) {}
+
+		~Registry() {
+			for (auto buffer : buffers_)
+				if (buffer->isOrphaned())
+					delete buffer;
+		}
+
+		std::mutex mutex_; // guards buffers_ and their names, only taken once per thread and by the exporter
+		std::vector<ProfileBuffer*> buffers_;
+		std::uint32_t next_id_;
+		std::uint64_t origin_; // all timestamps are exported relative to it, so they fit a double
+	};
+
+	Registry& registry() {
+		static Registry registry;
+		return registry;
+	}
+
+	// owns the buffer of the current thread, which is only created once the thread records a zone
+	struct BufferHolder {
+		BufferHolder() : buffer_(nullptr) {}
+		~BufferHolder() {
+			if (buffer_)
+				buffer_->orphan();
+		}
+
+		ProfileBuffer* buffer_;
+		std::string name_;
+	};
+
+	BufferHolder& localHolder() {
+		static thread_local BufferHolder holder;
+		return holder;
+	}
+
+	ProfileBuffer& localBuffer() {
+		BufferHolder& holder = localHolder();
+
+		if (!holder.buffer_) {
+			Registry& r = registry();
+			std::lock_guard<std::mutex> lock(r.mutex_);
+
+			holder.buffer_ = new ProfileBuffer(r.next_id_++);
+			holder.buffer_->name_ = holder.name_;
+			r.buffers_.push_back(holder.buffer_);
+		}
+
+		return *holder.buffer_;
+	}
+
+	void writeEscaped(std::ostream& out, const char* str) {
+		for (; *str; ++str) {
+			char c = *str;
+
+			if (c == '"' || c == '\\')
+				out << '\\' << c;
+			else if (static_cast<unsigned char>(c) < 0x20)
+				out << ' ';
+			else
+				out << c;
+		}
+	}
+
+	// microseconds since the registry's origin, with nanosecond precision
+	void writeTimestamp(std::ostream& out, std::uint64_t ticks, std::uint64_t origin) {
+		auto nanoseconds = ticks > origin ? MonotonicClock::toDuration(ticks - origin).count() : 0;
+
+		char digits[32];
+		std::snprintf(digits, sizeof(digits), "%.3f", nanoseconds / 1000.0);
+		out << digits;
+	}
+}
+
+std::atomic<bool> Profiler::is_enabled_(false);
+
+void Profiler::setEnabled(bool enabled) {
+	registry(); // fixes the origin before the first zone
+	is_enabled_.store(enabled);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+	BufferHolder& holder = localHolder();
+	holder.name_ = name;
+
+	if (holder.buffer_) {
+		std::lock_guard<std::mutex> lock(registry().mutex_);
+		holder.buffer_->name_ = name;
+	}
+}
+
+bool Profiler::begin(const ProfileZone& zone) {
+	return localBuffer().tryBegin(zone, MonotonicClock::ticks());
+}
+
+void Profiler::end() {
+	auto ticks = MonotonicClock::ticks();
+	localBuffer().end(ticks);
+}
+
+size_t Profiler::writeChromeTrace(std::ostream& out) {
+	Registry& r = registry();
+	size_t zones = 0;
+	std::uint64_t dropped = 0;
+	{
+		std::lock_guard<std::mutex> lock(r.mutex_);
+		const char* separator = "\n";
+
+		out << "{\"traceEvents\":[";
+
+		for (auto it = r.buffers_.begin(); it != r.buffers_.end();) {
+			ProfileBuffer* buffer = *it;
+			bool isOrphaned = buffer->isOrphaned(); // read before draining, so nothing recorded before the thread exited is lost
+
+			if (!buffer->name_.empty()) {
+				out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id() << ",\"args\":{\"name\":\"";
+				writeEscaped(out, buffer->name_.c_str());
+				out << "\"}}";
+				separator = ",\n";
+			}
+
+			size_t open = 0; // zones of this trace, ends of zones that began before the last export are skipped
+
+			buffer->consume([&](const Event& event) {
+				if (!event.zone_ && open == 0)
+					return;
+
+				out << separator << "{\"ph\":\"" << (event.zone_ ? 'B' : 'E') << "\",\"pid\":1,\"tid\":" << buffer->id() << ",\"ts\":";
+				writeTimestamp(out, event.ticks_, r.origin_);
+				separator = ",\n";
+
+				if (event.zone_) {
+					out << ",\"name\":\"";
+					writeEscaped(out, event.zone_->name_);
+					out << "\",\"cat\":\"furry2d\",\"args\":{\"file\":\"";
+					writeEscaped(out, event.zone_->file_);
+					out << "\",\"line\":" << event.zone_->line_ << "}";
+
+					++open;
+					++zones;
+				}
+				else
+					--open;
+
+				out << "}";
+			});
+
+			dropped += buffer->takeDropped();
+
+			if (isOrphaned) {
+				delete buffer;
+				it = r.buffers_.erase(it);
+			}
+			else
+				++it;
+		}
+
+		out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+
+	// not under the lock, logging records zones itself
+	if (dropped > 0)
+		gLogWarning << dropped << " profiling zones dropped, a thread's buffer was full";
+
+	return zones;
+}
+
+bool Profiler::writeChromeTrace(const std::string& filename) {
+	std::ofstream out(filename, std::ios::trunc);
+	if (!out.good())
+		return false;
+
+	writeChromeTrace(out);
+	return out.good();
+}
+
+void Profiler::clear() {
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex_);
+
+	for (auto it = r.buffers_.begin(); it != r.buffers_.end();) {
+		ProfileBuffer* buffer = *it;
+		bool isOrphaned = buffer->isOrphaned();
+
+		buffer->consume([](const Event&) {});
+		buffer->takeDropped();
+
+		if (isOrphaned) {
+			delete buffer;
+			it = r.buffers_.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+FURRY_NS_END
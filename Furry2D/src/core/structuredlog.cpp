@@ -0,0 +1,338 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <unordered_map>
+
+FURRY_NS_BEGIN
+
+namespace {
+	template <typename T>
+	bool read(std::istream& in, T& value) {
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	template <typename tLength>
+	bool readString(std::istream& in, std::string& str) {
+		tLength length;
+		if (!read(in, length))
+			return false;
+
+		str.resize(length);
+		return length == 0 || static_cast<bool>(in.read(&str[0], length));
+	}
+
+	// decodes the next argument and appends it, false if there is none left
+	bool appendArgument(std::string& out, const char*& data, const char* end) {
+		using namespace detail;
+
+		if (data == end)
+			return false;
+
+		auto tag = static_cast<std::uint8_t>(*data++);
+		char buffer[32];
+		int length = 0;
+
+		auto take = [&data, end](void* value, size_t size) {
+			if (static_cast<size_t>(end - data) < size)
+				return false;
+
+			std::memcpy(value, data, size);
+			data += size;
+			return true;
+		};
+
+		switch (tag) {
+		case kLogInt: {
+			long long value;
+			if (!take(&value, sizeof(value))) return false;
+			length = std::snprintf(buffer, sizeof(buffer), "%lld", value);
+			break;
+		}
+		case kLogUInt: {
+			unsigned long long value;
+			if (!take(&value, sizeof(value))) return false;
+			length = std::snprintf(buffer, sizeof(buffer), "%llu", value);
+			break;
+		}
+		case kLogDouble: {
+			double value;
+			if (!take(&value, sizeof(value))) return false;
+			length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+			break;
+		}
+		case kLogBool: {
+			std::uint8_t value;
+			if (!take(&value, sizeof(value))) return false;
+			out.append(value ? "true" : "false");
+			return true;
+		}
+		case kLogChar: {
+			char value;
+			if (!take(&value, sizeof(value))) return false;
+			out.push_back(value);
+			return true;
+		}
+		case kLogString: {
+			std::uint16_t size;
+			if (!take(&size, sizeof(size)) || static_cast<size_t>(end - data) < size) return false;
+			out.append(data, size);
+			data += size;
+			return true;
+		}
+		case kLogPointer: {
+			std::uint64_t value;
+			if (!take(&value, sizeof(value))) return false;
+			length = std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(value));
+			break;
+		}
+		default:
+			data = end; // unknown tag, nothing after it can be trusted
+			return false;
+		}
+
+		if (length > 0)
+			out.append(buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+
+		return true;
+	}
+}
+
+/*** LogArgumentEncoder ***/
+LogArgumentEncoder::LogArgumentEncoder(const LogDescriptor& descriptor) :
+	is_active_(logLevel(descriptor.level_)),
+	is_wanted_(is_active_ || FlightRecorder::isEnabled())
+{
+	record_.timestamp_ = MonotonicClock::ticks();
+	record_.descriptor_ = &descriptor;
+	record_.file_ = descriptor.file_;
+	record_.line_ = descriptor.line_;
+	record_.level_ = descriptor.level_;
+	record_.length_ = 0;
+}
+
+void LogArgumentEncoder::push() {
+	if (FlightRecorder::isEnabled())
+		FlightRecorder::record(record_);
+
+	if (is_active_)
+		LogBackend::push(record_);
+}
+
+void LogArgumentEncoder::append(std::uint8_t tag, const void* data, size_t size) {
+	if (LogRecord::kTextCapacity - record_.length_ < size + 1)
+		return; // does not fit, the formatter shows the missing argument
+
+	record_.text_[record_.length_] = static_cast<char>(tag);
+	std::memcpy(record_.text_ + record_.length_ + 1, data, size);
+	record_.length_ += static_cast<std::uint16_t>(size + 1);
+}
+
+void LogArgumentEncoder::encode(const char* str) {
+	encodeString(str, std::strlen(str));
+}
+
+void LogArgumentEncoder::encodeString(const char* str, size_t size) {
+	size_t available = LogRecord::kTextCapacity - record_.length_;
+
+	if (available < 1 + sizeof(std::uint16_t))
+		return;
+
+	size = std::min(size, available - 1 - sizeof(std::uint16_t)); // truncated
+
+	auto length = static_cast<std::uint16_t>(size);
+	char* out = record_.text_ + record_.length_;
+
+	*out++ = static_cast<char>(detail::kLogString);
+	std::memcpy(out, &length, sizeof(length));
+	std::memcpy(out + sizeof(length), str, size);
+
+	record_.length_ += static_cast<std::uint16_t>(1 + sizeof(length) + size);
+}
+
+void LogArgumentEncoder::encode(const std::string& str) {
+	encodeString(str.data(), str.size()); // keeps embedded zeros
+}
+
+void LogArgumentEncoder::encode(char c) {
+	append(detail::kLogChar, &c, sizeof(c));
+}
+
+void LogArgumentEncoder::encode(bool b) {
+	std::uint8_t value = b ? 1 : 0;
+	append(detail::kLogBool, &value, sizeof(value));
+}
+
+void LogArgumentEncoder::encode(short i) {
+	encode(static_cast<long long>(i));
+}
+
+void LogArgumentEncoder::encode(unsigned short i) {
+	encode(static_cast<unsigned long long>(i));
+}
+
+void LogArgumentEncoder::encode(int i) {
+	encode(static_cast<long long>(i));
+}
+
+void LogArgumentEncoder::encode(unsigned int i) {
+	encode(static_cast<unsigned long long>(i));
+}
+
+void LogArgumentEncoder::encode(long i) {
+	encode(static_cast<long long>(i));
+}
+
+void LogArgumentEncoder::encode(unsigned long i) {
+	encode(static_cast<unsigned long long>(i));
+}
+
+void LogArgumentEncoder::encode(long long i) {
+	append(detail::kLogInt, &i, sizeof(i));
+}
+
+void LogArgumentEncoder::encode(unsigned long long i) {
+	append(detail::kLogUInt, &i, sizeof(i));
+}
+
+void LogArgumentEncoder::encode(float f) {
+	encode(static_cast<double>(f));
+}
+
+void LogArgumentEncoder::encode(double d) {
+	append(detail::kLogDouble, &d, sizeof(d));
+}
+
+void LogArgumentEncoder::encode(const void* p) {
+	std::uint64_t value = reinterpret_cast<std::uintptr_t>(p);
+	append(detail::kLogPointer, &value, sizeof(value));
+}
+
+/*** formatting ***/
+std::string formatLogArguments(const char* format, const char* data, size_t size) {
+	std::string out;
+	out.reserve(std::strlen(format) + size);
+
+	const char* end = data + size;
+
+	for (const char* c = format; *c; ++c) {
+		if (c[0] == '{' && c[1] == '}') {
+			if (!appendArgument(out, data, end))
+				out.append("{?}");
+			++c;
+		}
+		else
+			out.push_back(*c);
+	}
+
+	return out;
+}
+
+/*** LogDecoder ***/
+LogDecoder::LogDecoder(std::istream& in) : in_(in) {
+}
+
+size_t LogDecoder::decode(std::ostream& out) {
+	std::uint32_t magic = 0, version = 0;
+	if (!read(in_, magic) || !read(in_, version) || magic != kMagic)
+		throw std::runtime_error("Not a binary log");
+
+	if (version != kVersion)
+		throw std::runtime_error("Unsupported binary log version");
+
+	struct Site {
+		LogLevel level_;
+		std::uint32_t line_;
+		std::string file_;
+		std::string format_;
+	};
+
+	std::unordered_map<std::uint64_t, Site> sites;
+	std::string file, message;
+	size_t count = 0;
+
+	auto print = [&out, &count](std::uint64_t timestamp, LogLevel level, const std::string& message, const std::string& file, std::uint32_t line) {
+		auto time_t = static_cast<std::time_t>(timestamp / 1000000000ull);
+#ifdef FURRY_COMPILER_VC
+		tm lt;
+		localtime_s(&lt, &time_t);
+		auto local_time = &lt;
+#else
+		auto local_time = std::localtime(&time_t);
+#endif
+		out
+			<< std::put_time(local_time, "[%H:%M:%S] ")
+			<< level
+			<< message
+			<< " ("
+			<< file
+			<< ":"
+			<< line
+			<< ")\n";
+
+		++count;
+	};
+
+	std::uint8_t kind;
+
+	while (read(in_, kind)) {
+		std::uint64_t id = 0, timestamp = 0;
+		std::uint8_t level = 0;
+		std::uint32_t line = 0;
+
+		switch (kind) {
+		case kDescriptor: {
+			Site site;
+			if (!read(in_, id) || !read(in_, level) || !read(in_, site.line_) ||
+				!readString<std::uint16_t>(in_, site.file_) || !readString<std::uint16_t>(in_, site.format_))
+				return count;
+
+			site.level_ = static_cast<LogLevel>(level);
+			sites[id] = std::move(site);
+			break;
+		}
+		case kRecord: {
+			if (!read(in_, id) || !read(in_, timestamp) || !readString<std::uint16_t>(in_, message))
+				return count;
+
+			auto it = sites.find(id);
+			if (it == sites.end())
+				throw std::runtime_error("Binary log refers to an unknown call site");
+
+			const Site& site = it->second;
+			print(timestamp, site.level_, formatLogArguments(site.format_.c_str(), message.data(), message.size()), site.file_, site.line_);
+			break;
+		}
+		case kText: {
+			if (!read(in_, timestamp) || !read(in_, level) || !read(in_, line) ||
+				!readString<std::uint16_t>(in_, file) || !readString<std::uint32_t>(in_, message))
+				return count;
+
+			print(timestamp, static_cast<LogLevel>(level), message, file, line);
+			break;
+		}
+		default:
+			throw std::runtime_error("Binary log is corrupt");
+		}
+	}
+
+	return count; // a truncated tail (e.g. after a crash) is silently ignored
+}
+
+FURRY_NS_END
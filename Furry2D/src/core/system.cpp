@@ -14,10 +14,25 @@
 */
 
 #include <furry2d/furry2d.h>
+#include <atomic>
 
 FURRY_NS_BEGIN
 
-System::System(std::string name) : name_{std::move(name)}
+namespace detail {
+	size_t nextSystemTypeIndex() {
+		static std::atomic<size_t> next(0);
+		return next++;
+	}
+}
+
+System::System(std::string name) :
+	engine_(nullptr),
+	name_{std::move(name)},
+	is_main_thread_only_(false),
+	budget_(0),
+	type_index_(static_cast<size_t>(-1)),
+	position_(0),
+	order_(0)
 {}
 
 bool System::initialize() {
@@ -35,4 +50,21 @@ void System::shutdown() {
 #endif
 }
 
+void System::addDependency(std::string systemName) {
+	dependencies_.push_back(std::move(systemName));
+}
+
+void System::setMainThreadOnly(bool enabled) {
+	is_main_thread_only_ = enabled;
+}
+
+void System::setBudget(std::chrono::microseconds budget) {
+	budget_ = budget;
+}
+
+void System::budgetExceeded(std::chrono::microseconds cost) {
+	gLogLimited(EWarning, 5) << getName() << " took " << cost.count() / 1000.0
+		<< " ms this frame, its budget is " << budget_.count() / 1000.0 << " ms";
+}
+
 FURRY_NS_END
\ No newline at end of file
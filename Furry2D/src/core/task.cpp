@@ -23,8 +23,9 @@ namespace detail {
 	/*** WrappedTask ***/
 	WrappedTask::WrappedTask() {}
 
-	WrappedTask::WrappedTask(Task task, bool repeating, bool background) :
-		unwrapped_task_{ std::move(task) } {
+	WrappedTask::WrappedTask(Task task, bool repeating, bool background, std::string label) :
+		unwrapped_task_{ std::move(task) },
+		label_{ std::move(label) } {
 		is_repeating_ = repeating;
 		is_background_ = background;
 	}
@@ -51,6 +52,13 @@ namespace detail {
 		return is_background_;
 	}
 
+	const char* WrappedTask::name() const {
+		if (!label_.empty())
+			return label_.c_str();
+
+		return unwrapped_task_.target_type().name();
+	}
+
 	void WrappedTask::setRepeating(bool enabled) {
 		is_repeating_ = enabled;
 	}
@@ -63,8 +71,9 @@ namespace detail {
 detail::WrappedTask make_wrapped(
 	Task task,
 	bool repeating,
-	bool background) {
-	return detail::WrappedTask{ task, repeating, background };
+	bool background,
+	std::string label) {
+	return detail::WrappedTask{ std::move(task), repeating, background, std::move(label) };
 }
 
 FURRY_NS_END
\ No newline at end of file
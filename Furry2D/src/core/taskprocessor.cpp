@@ -14,6 +14,9 @@
 */
 
 #include <furry2d/furry2d.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 
 FURRY_NS_BEGIN
@@ -29,8 +32,8 @@ TaskProcessor::TaskProcessor(size_t numWorkers) :
 		num_workers_ = 1; // keep at least 1 background thread
 }
 
-void TaskProcessor::addWork(Task t, bool repeating, bool background) {
-	addWork(make_wrapped(std::move(t), repeating, background));
+void TaskProcessor::addWork(Task t, bool repeating, bool background, std::string label) {
+	addWork(make_wrapped(std::move(t), repeating, background, std::move(label)));
 }
 
 void TaskProcessor::addRepeatingWork(Task t, bool background) {
@@ -54,19 +57,26 @@ void TaskProcessor::start() {
 
 	// start the workers
 	for (size_t i = 0; i < num_workers_; ++i) {
-		background_workers_.push_back(std::thread([&] {
+		background_workers_.push_back(std::thread([&, i] {
+			Profiler::setThreadName("background worker " + std::to_string(i));
+
+			if (FlightRecorder::isEnabled())
+				FlightRecorder::recordEvent("background worker started", __FILE__, __LINE__);
+
 			while (is_running_) {
 				detail::WrappedTask t;
 
 				background_tasks_.pop_back(t);
 
 				if (is_running_)
-					execute(t);
+					execute(std::move(t));
 			}
 		}));
 	}
 
 	// start the main executor
+	Profiler::setThreadName("main");
+
 	while (is_running_) {
 		TaskQueue localQueue;
 		main_tasks_.swap(localQueue);
@@ -85,6 +95,98 @@ void TaskProcessor::stop() {
 
 	for (auto &t : background_workers_)
 		t.join();
+
+	background_workers_.clear(); // stop() may be called again, e.g. by the Engine's destructor
+}
+
+bool TaskProcessor::runGraph(const std::vector<GraphTask>& tasks) {
+	size_t count = tasks.size();
+
+	std::vector<std::vector<size_t>> dependents(count);
+	std::vector<size_t> remaining(count);
+
+	for (size_t i = 0; i < count; ++i) {
+		for (auto dependency : tasks[i].dependencies_) {
+			if (dependency >= count || dependency == i)
+				return false;
+
+			dependents[dependency].push_back(i);
+		}
+
+		remaining[i] = tasks[i].dependencies_.size();
+	}
+
+	// check for cycles before running anything
+	{
+		std::vector<size_t> open = remaining;
+		std::vector<size_t> ready;
+
+		for (size_t i = 0; i < count; ++i)
+			if (open[i] == 0)
+				ready.push_back(i);
+
+		for (size_t visited = 0; visited < ready.size(); ++visited)
+			for (auto dependent : dependents[ready[visited]])
+				if (--open[dependent] == 0)
+					ready.push_back(dependent);
+
+		if (ready.size() != count)
+			return false;
+	}
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::deque<size_t> ready;
+	std::deque<size_t> main_ready; // only taken by the calling thread
+	size_t done = 0;
+
+	auto schedule = [&](size_t index) {
+		(tasks[index].is_main_thread_only_ ? main_ready : ready).push_back(index);
+	};
+
+	for (size_t i = 0; i < count; ++i)
+		if (remaining[i] == 0)
+			schedule(i);
+
+	auto work = [&](bool isCallingThread) {
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (done < count) {
+			auto& queue = isCallingThread && !main_ready.empty() ? main_ready : ready;
+
+			if (queue.empty()) {
+				changed.wait(lock);
+				continue;
+			}
+
+			size_t index = queue.front();
+			queue.pop_front();
+
+			lock.unlock();
+			tasks[index].task_();
+			lock.lock();
+
+			++done;
+			for (auto dependent : dependents[index])
+				if (--remaining[dependent] == 0)
+					schedule(dependent);
+
+			changed.notify_all();
+		}
+	};
+
+	size_t helperCount = count > 1 ? std::min(num_workers_, count - 1) : 0;
+
+	std::vector<std::thread> helpers;
+	for (size_t i = 0; i < helperCount; ++i)
+		helpers.push_back(std::thread(work, false));
+
+	work(true);
+
+	for (auto& helper : helpers)
+		helper.join();
+
+	return true;
 }
 
 void TaskProcessor::addWork(detail::WrappedTask t) {
@@ -95,6 +197,11 @@ void TaskProcessor::addWork(detail::WrappedTask t) {
 }
 
 void TaskProcessor::execute(detail::WrappedTask t) {
+	FURRY_PROFILE_ZONE("TaskProcessor::execute");
+
+	if (FlightRecorder::isEnabled())
+		FlightRecorder::recordEvent(t.name(), __FILE__, __LINE__);
+
 	t();
 
 	if (t.isRepeating())
@@ -38,6 +38,10 @@ void Active::send(Callback message) {
 	queue_.push(std::move(message));
 }
 
+bool Active::isCurrentThread() const {
+	return std::this_thread::get_id() == thread_.get_id();
+}
+
 void Active::run() {
 	while (!done_) {
 		Callback cb;
@@ -0,0 +1,100 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+#ifdef FURRY_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <time.h>
+#endif
+
+FURRY_NS_BEGIN
+
+namespace {
+	struct Calibration {
+		Calibration() {
+			using namespace std::chrono;
+#ifdef FURRY_PLATFORM_WINDOWS
+			LARGE_INTEGER frequency;
+			QueryPerformanceFrequency(&frequency);
+			frequency_ = static_cast<std::uint64_t>(frequency.QuadPart);
+#else
+			frequency_ = 1000000000ull; // the ticks already are nanoseconds
+#endif
+			// take the system time in the middle of two counter reads to halve the error
+			std::uint64_t before = MonotonicClock::ticks();
+			auto wall = system_clock::now();
+			std::uint64_t after = MonotonicClock::ticks();
+
+			base_ticks_ = before + (after - before) / 2;
+			base_wall_ = duration_cast<nanoseconds>(wall.time_since_epoch());
+		}
+
+		std::uint64_t frequency_;
+		std::uint64_t base_ticks_;
+		std::chrono::nanoseconds base_wall_;
+	};
+
+	const Calibration& calibration() {
+		static Calibration calibration;
+		return calibration;
+	}
+}
+
+std::uint64_t MonotonicClock::ticks() {
+#ifdef FURRY_PLATFORM_WINDOWS
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return static_cast<std::uint64_t>(counter.QuadPart);
+#else
+	timespec ts;
+#	ifdef CLOCK_MONOTONIC_RAW
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#	else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#	endif
+	return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+#endif
+}
+
+std::uint64_t MonotonicClock::frequency() {
+	return calibration().frequency_;
+}
+
+MonotonicClock::duration MonotonicClock::toDuration(std::uint64_t ticks) {
+	std::uint64_t frequency = calibration().frequency_;
+
+	// split to avoid overflowing ticks * 10^9
+	return duration(static_cast<rep>((ticks / frequency) * 1000000000ull + (ticks % frequency) * 1000000000ull / frequency));
+}
+
+MonotonicClock::duration MonotonicClock::sinceEpoch(std::uint64_t ticks) {
+	const Calibration& c = calibration();
+
+	if (ticks >= c.base_ticks_)
+		return c.base_wall_ + toDuration(ticks - c.base_ticks_);
+
+	return c.base_wall_ - toDuration(c.base_ticks_ - ticks);
+}
+
+std::chrono::system_clock::time_point MonotonicClock::toSystemTime(std::uint64_t ticks) {
+	using namespace std::chrono;
+	return system_clock::time_point(duration_cast<system_clock::duration>(sinceEpoch(ticks)));
+}
+
+FURRY_NS_END
@@ -0,0 +1,137 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <sys/stat.h>
+#include <thread>
+
+#ifdef FURRY_PLATFORM_LINUX
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <unistd.h>
+#endif
+
+FURRY_NS_BEGIN
+
+namespace {
+	// modification time and size, or false if the file does not exist (right now)
+	bool fileStatus(const std::string& filename, std::int64_t& modified, std::int64_t& size) {
+		struct stat info;
+		if (stat(filename.c_str(), &info) != 0)
+			return false;
+
+		modified = static_cast<std::int64_t>(info.st_mtime);
+		size = static_cast<std::int64_t>(info.st_size);
+		return true;
+	}
+}
+
+FileWatcher::FileWatcher() : fd_(-1) {
+#ifdef FURRY_PLATFORM_LINUX
+	fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (fd_ < 0)
+		gLogWarning << "inotify is not available, falling back to polling for file changes";
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef FURRY_PLATFORM_LINUX
+	if (fd_ >= 0)
+		close(fd_);
+#endif
+}
+
+bool FileWatcher::add(const std::string& filename) {
+	Watch watch;
+	watch.filename_ = filename;
+	watch.descriptor_ = -1;
+	watch.modified_ = 0;
+	watch.size_ = 0;
+
+	if (!fileStatus(filename, watch.modified_, watch.size_))
+		return false;
+
+	size_t slash = filename.find_last_of("/\\");
+	watch.name_ = slash == std::string::npos ? filename : filename.substr(slash + 1);
+
+#ifdef FURRY_PLATFORM_LINUX
+	if (fd_ >= 0) {
+		std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : filename.substr(0, slash);
+
+		watch.descriptor_ = inotify_add_watch(fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (watch.descriptor_ < 0)
+			return false;
+	}
+#endif
+
+	ScopedLock lock(mutex_);
+	watches_.push_back(std::move(watch));
+	return true;
+}
+
+std::vector<std::string> FileWatcher::wait(std::chrono::milliseconds timeout) {
+	std::vector<std::string> changed;
+
+	auto report = [&changed](const Watch& watch) {
+		if (std::find(changed.begin(), changed.end(), watch.filename_) == changed.end())
+			changed.push_back(watch.filename_);
+	};
+
+#ifdef FURRY_PLATFORM_LINUX
+	if (fd_ >= 0) {
+		pollfd request = { fd_, POLLIN, 0 };
+		if (poll(&request, 1, static_cast<int>(timeout.count())) <= 0)
+			return changed;
+
+		alignas(inotify_event) char buffer[4096];
+		ssize_t length;
+
+		while ((length = read(fd_, buffer, sizeof(buffer))) > 0) {
+			for (char* p = buffer; p < buffer + length;) {
+				auto event = reinterpret_cast<const inotify_event*>(p);
+				p += sizeof(inotify_event) + event->len;
+
+				if (event->len == 0)
+					continue;
+
+				ScopedLock lock(mutex_);
+				for (auto&& watch : watches_)
+					if (watch.descriptor_ == event->wd && watch.name_ == event->name)
+						report(watch);
+			}
+		}
+
+		return changed;
+	}
+#endif
+
+	std::this_thread::sleep_for(timeout);
+
+	ScopedLock lock(mutex_);
+	for (auto&& watch : watches_) {
+		std::int64_t modified, size;
+
+		if (fileStatus(watch.filename_, modified, size) && (modified != watch.modified_ || size != watch.size_)) {
+			watch.modified_ = modified;
+			watch.size_ = size;
+			report(watch);
+		}
+	}
+
+	return changed;
+}
+
+FURRY_NS_END
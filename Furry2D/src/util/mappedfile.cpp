@@ -0,0 +1,123 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+#ifdef FURRY_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+FURRY_NS_BEGIN
+
+MappedFile::MappedFile() :
+	data_(nullptr),
+	size_(0),
+	is_open_(false)
+#ifdef FURRY_PLATFORM_WINDOWS
+	, file_(INVALID_HANDLE_VALUE)
+	, mapping_(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+	close();
+
+#ifdef FURRY_PLATFORM_WINDOWS
+	file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size)) {
+		close();
+		return false;
+	}
+
+	size_ = static_cast<size_t>(size.QuadPart);
+
+	if (size_ > 0) { // empty files can't be mapped
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		data_ = mapping_ ? static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+		if (!data_) {
+			close();
+			return false;
+		}
+	}
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		::close(fd);
+		return false;
+	}
+
+	size_ = static_cast<size_t>(info.st_size);
+
+	if (size_ > 0) { // empty files can't be mapped
+		void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			::close(fd);
+			size_ = 0;
+			return false;
+		}
+
+		data_ = static_cast<const char*>(data);
+	}
+
+	::close(fd); // the mapping keeps the file
+#endif
+
+	is_open_ = true;
+	return true;
+}
+
+void MappedFile::close() {
+#ifdef FURRY_PLATFORM_WINDOWS
+	if (data_)
+		UnmapViewOfFile(data_);
+	if (mapping_)
+		CloseHandle(mapping_);
+	if (file_ != INVALID_HANDLE_VALUE)
+		CloseHandle(file_);
+
+	mapping_ = nullptr;
+	file_ = INVALID_HANDLE_VALUE;
+#else
+	if (data_)
+		munmap(const_cast<char*>(data_), size_);
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	is_open_ = false;
+}
+
+FURRY_NS_END
@@ -0,0 +1,433 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+
+#include <gmock/gmock.h>
+
+using ::FURRY_NS::Channel;
+using ::FURRY_NS::MessageHandler;
+using ::FURRY_NS::BatchHandler;
+using ::FURRY_NS::Span;
+using ::FURRY_NS::Lane;
+using ::FURRY_NS::Delivery;
+using ::FURRY_NS::StaticChannel;
+using ::FURRY_NS::FunctionHandler;
+using ::FURRY_NS::MessageConsumer;
+using ::FURRY_NS::EventArena;
+using ::FURRY_NS::PooledString;
+using ::FURRY_NS::ChannelMetrics;
+using ::FURRY_NS::ConcurrentSnapshot;
+using ::testing::Eq;
+
+namespace {
+	struct Ping {
+		int value_;
+	};
+
+	struct PingCounter : MessageHandler<Ping> {
+		PingCounter() : count_(0), sum_(0) {}
+
+		void operator()(const Ping& ping) override {
+			++count_;
+			sum_ += ping.value_;
+		}
+
+		int count_;
+		int sum_;
+	};
+
+	struct SelfRemovingHandler {
+		SelfRemovingHandler() : count_(0) {
+			Channel::add<Ping>(this);
+		}
+
+		void operator()(const Ping&) {
+			++count_;
+			Channel::remove<Ping>(this);
+		}
+
+		int count_;
+	};
+}
+
+TEST(Channel, BroadcastReachesEveryRegisteredHandler) {
+	PingCounter a, b;
+
+	Channel::broadcast(Ping{ 3 });
+
+	ASSERT_THAT(a.sum_, Eq(3));
+	ASSERT_THAT(b.sum_, Eq(3));
+}
+
+TEST(Channel, RemovedHandlerIsNotCalledAnymore) {
+	PingCounter a;
+	{
+		PingCounter b;
+		Channel::broadcast(Ping{ 1 });
+		ASSERT_THAT(b.count_, Eq(1));
+	}
+	Channel::broadcast(Ping{ 1 });
+
+	ASSERT_THAT(a.count_, Eq(2));
+}
+
+TEST(Channel, HandlerMayRemoveItselfWhileBroadcasting) {
+	SelfRemovingHandler handler;
+	PingCounter counter;
+
+	Channel::broadcast(Ping{ 1 });
+	Channel::broadcast(Ping{ 1 });
+
+	ASSERT_THAT(handler.count_, Eq(1));
+	ASSERT_THAT(counter.count_, Eq(2));
+}
+
+TEST(Channel, ConcurrentBroadcastsAndSubscriptionsAreSafe) {
+	PingCounter counter;
+	std::atomic<bool> done(false);
+
+	// note that removal does not wait for in-flight broadcasts, so the churning handler is never destroyed here
+	struct Idle {
+		void operator()(const Ping&) {}
+	} idle;
+
+	std::thread churn([&] {
+		while (!done) {
+			Channel::add<Ping>(&idle);
+			Channel::remove<Ping>(&idle);
+		}
+	});
+
+	for (int i = 0; i < 10000; ++i)
+		Channel::broadcast(Ping{ 1 });
+
+	done = true;
+	churn.join();
+
+	ASSERT_THAT(counter.sum_, Eq(10000));
+}
+
+namespace {
+	int gLiveSnapshots = 0;
+
+	struct Counted {
+		Counted() { ++gLiveSnapshots; }
+		Counted(const Counted&) { ++gLiveSnapshots; }
+		~Counted() { --gLiveSnapshots; }
+	};
+}
+
+TEST(ConcurrentSnapshot, OldSnapshotsAreFreedWhileNewerOnesAreRead) {
+	{
+		ConcurrentSnapshot<Counted> snapshot;
+
+		// readers overlap all the time, but every old snapshot loses its last reader
+		typedef ConcurrentSnapshot<Counted>::ReadGuard ReadGuard;
+		std::unique_ptr<ReadGuard> reader(new ReadGuard(snapshot.read()));
+
+		for (int i = 0; i < 100; ++i) {
+			snapshot.update([](Counted&) {});
+
+			std::unique_ptr<ReadGuard> next(new ReadGuard(snapshot.read()));
+			reader = std::move(next);
+		}
+
+		ASSERT_THAT(gLiveSnapshots, Eq(1));
+	}
+
+	ASSERT_THAT(gLiveSnapshots, Eq(0));
+}
+
+namespace {
+	struct Contact {
+		int id_;
+	};
+
+	struct ContactBatchCounter : BatchHandler<Contact> {
+		ContactBatchCounter() : batches_(0), contacts_(0) {}
+
+		void operator()(Span<const Contact> contacts) override {
+			++batches_;
+			contacts_ += contacts.size();
+		}
+
+		int batches_;
+		size_t contacts_;
+	};
+}
+
+TEST(Channel, PostedEventsAreDeliveredOnDispatchOnly) {
+	ContactBatchCounter counter;
+
+	for (int i = 0; i < 100; ++i)
+		Channel::post(Contact{ i });
+
+	ASSERT_THAT(counter.contacts_, Eq(0u));
+
+	Channel::dispatch();
+
+	ASSERT_THAT(counter.batches_, Eq(1));
+	ASSERT_THAT(counter.contacts_, Eq(100u));
+
+	Channel::dispatch();
+
+	ASSERT_THAT(counter.batches_, Eq(1));
+}
+
+TEST(Channel, PostedEventsReachMessageHandlersInOrder) {
+	struct Recorder : MessageHandler<Contact> {
+		void operator()(const Contact& contact) override {
+			ids_.push_back(contact.id_);
+		}
+		std::vector<int> ids_;
+	} recorder;
+
+	Channel::post(Contact{ 1 });
+	Channel::post(Contact{ 2 });
+	Channel::dispatch();
+
+	ASSERT_THAT(recorder.ids_, ::testing::ElementsAre(1, 2));
+}
+
+namespace {
+	struct Position {
+		int x_;
+	};
+
+	struct PositionTracker : MessageHandler<Position> {
+		PositionTracker(Lane& lane, Delivery delivery) : MessageHandler<Position>(lane, delivery) {}
+
+		void operator()(const Position& position) override {
+			seen_.push_back(position.x_);
+			thread_ = std::this_thread::get_id();
+		}
+
+		std::vector<int> seen_;
+		std::thread::id thread_;
+	};
+}
+
+TEST(Channel, LaneHandlersRunOnlyWhenTheirLaneIsDrained) {
+	Lane lane;
+	PositionTracker tracker(lane, Delivery::Queued);
+
+	std::thread producer([] {
+		Channel::broadcast(Position{ 1 });
+		Channel::broadcast(Position{ 2 });
+	});
+	producer.join();
+
+	ASSERT_THAT(tracker.seen_.size(), Eq(0u));
+	ASSERT_THAT(lane.drain(), Eq(1u)); // both events travel in one lane message
+	ASSERT_THAT(tracker.seen_, ::testing::ElementsAre(1, 2));
+	ASSERT_THAT(tracker.thread_, Eq(std::this_thread::get_id()));
+}
+
+TEST(Channel, LatestDeliveryCoalescesPendingEvents) {
+	Lane lane;
+	PositionTracker tracker(lane, Delivery::Latest);
+
+	for (int i = 0; i < 10; ++i)
+		Channel::broadcast(Position{ i });
+
+	lane.drain();
+
+	ASSERT_THAT(tracker.seen_, ::testing::ElementsAre(9));
+}
+
+TEST(Channel, RemovedLaneHandlerDoesNotReceivePendingEvents) {
+	Lane lane;
+	{
+		PositionTracker tracker(lane, Delivery::Queued);
+		Channel::broadcast(Position{ 1 });
+	}
+
+	ASSERT_THAT(lane.drain(), Eq(1u)); // runs the stale delivery, which must not touch the handler
+}
+
+namespace {
+	struct Hit {
+		int damage_;
+	};
+
+	int gTotalDamage = 0;
+	int gHitCount = 0;
+
+	struct SumDamage {
+		void operator()(const Hit& hit) const {
+			gTotalDamage += hit.damage_;
+		}
+	};
+
+	void countHit(const Hit&) {
+		++gHitCount;
+	}
+
+	typedef StaticChannel<Hit, SumDamage, FunctionHandler<Hit, &countHit>> HitChannel;
+}
+
+TEST(StaticChannel, BroadcastCallsEveryHandler) {
+	gTotalDamage = gHitCount = 0;
+
+	HitChannel::broadcast(Hit{ 5 });
+
+	ASSERT_THAT(gTotalDamage, Eq(5));
+	ASSERT_THAT(gHitCount, Eq(1));
+}
+
+TEST(StaticChannel, BroadcastsWholeBatches) {
+	gTotalDamage = gHitCount = 0;
+	Hit hits[] = { { 1 }, { 2 }, { 3 } };
+
+	HitChannel::broadcast(Span<const Hit>(hits, 3));
+
+	ASSERT_THAT(gTotalDamage, Eq(6));
+	ASSERT_THAT(gHitCount, Eq(3));
+}
+
+namespace {
+	struct TextInput {
+		PooledString text_;
+	};
+
+	struct Packet {
+		std::vector<char> bytes_;
+	};
+
+	struct PacketSink : MessageConsumer<Packet> {
+		void operator()(Span<Packet> packets) override {
+			for (auto& packet : packets)
+				kept_.push_back(std::move(packet.bytes_));
+		}
+
+		std::vector<std::vector<char>> kept_;
+	};
+}
+
+TEST(EventArena, AllocationsAreAlignedAndFallBackToTheHeap) {
+	EventArena arena(64);
+
+	void* a = arena.allocate(8, 16);
+	void* b = arena.allocate(8, 16);
+
+	ASSERT_THAT(reinterpret_cast<std::uintptr_t>(a) % 16, Eq(0u));
+	ASSERT_THAT(reinterpret_cast<std::uintptr_t>(b) % 16, Eq(0u));
+	ASSERT_THAT(arena.overflowCount(), Eq(0u));
+
+	arena.allocate(128);
+	ASSERT_THAT(arena.overflowCount(), Eq(1u));
+
+	arena.advance();
+	ASSERT_THAT(arena.overflowCount(), Eq(0u));
+}
+
+TEST(Channel, PostedEventsCanCarryPooledPayloads) {
+	struct Reader : MessageHandler<TextInput> {
+		void operator()(const TextInput& input) override {
+			text_ = input.text_.str();
+		}
+		std::string text_;
+	} reader;
+
+	Channel::post(TextInput{ EventArena::instance().copy(std::string("hello")) });
+	Channel::dispatch();
+
+	ASSERT_THAT(reader.text_, Eq("hello"));
+}
+
+TEST(Channel, ConsumersTakeOwnershipOfPostedEvents) {
+	PacketSink sink;
+
+	Channel::post(Packet{ std::vector<char>(100, 'x') });
+	Channel::dispatch();
+
+	ASSERT_THAT(sink.kept_.size(), Eq(1u));
+	ASSERT_THAT(sink.kept_[0].size(), Eq(100u));
+}
+
+namespace {
+	struct Tick {
+		int frame_;
+	};
+
+	struct SlowTickHandler : MessageHandler<Tick> {
+		SlowTickHandler() : MessageHandler<Tick>("SlowTickHandler") {}
+
+		void operator()(const Tick&) override {
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		void operator()(Span<const Tick>) {} // for the batch registration
+	};
+
+	struct FastTickHandler : MessageHandler<Tick> {
+		void operator()(const Tick&) override {}
+	};
+}
+
+TEST(ChannelMetrics, RecordsBroadcastsAndTheSlowestHandler) {
+	SlowTickHandler slow;
+	FastTickHandler fast;
+
+	ChannelMetrics::setEnabled(true);
+	Channel::broadcast(Tick{ 1 });
+	Channel::broadcast(Tick{ 2 });
+	ChannelMetrics::setEnabled(false);
+	Channel::broadcast(Tick{ 3 }); // not recorded anymore
+
+	// dropping the batch registration of the same object keeps the name of the message handler
+	Channel::addBatch<Tick>(&slow);
+	Channel::removeBatch<Tick>(&slow);
+
+	auto entries = ChannelMetrics::snapshot();
+	auto it = std::find_if(entries.begin(), entries.end(), [](const ChannelMetrics::Entry& entry) {
+		return entry.event_ == typeid(Tick).name();
+	});
+
+	ASSERT_TRUE(it != entries.end());
+	ASSERT_THAT(it->broadcasts_, Eq(2u));
+	ASSERT_THAT(it->handlers_, Eq(2u));
+	ASSERT_THAT(it->slowest_handler_, Eq(static_cast<const void*>(&slow)));
+	ASSERT_THAT(it->slowest_handler_name_, Eq("SlowTickHandler"));
+	ASSERT_GE(it->worst_handler_ms_, 2.0);
+}
+
+TEST(ChannelMetrics, HandlersWithoutANameAreReportedByTheirType) {
+	struct Listener {
+		void operator()(const Tick&) {
+			std::this_thread::sleep_for(std::chrono::microseconds(100)); // measurably more than nothing
+		}
+	} listener;
+
+	Channel::add<Tick>(&listener);
+	ChannelMetrics::reset();
+	ChannelMetrics::setEnabled(true);
+	Channel::broadcast(Tick{ 1 });
+	ChannelMetrics::setEnabled(false);
+
+	auto entries = ChannelMetrics::snapshot();
+	auto it = std::find_if(entries.begin(), entries.end(), [](const ChannelMetrics::Entry& entry) {
+		return entry.event_ == typeid(Tick).name();
+	});
+	Channel::remove<Tick>(&listener);
+
+	ASSERT_TRUE(it != entries.end());
+	ASSERT_THAT(it->slowest_handler_, Eq(static_cast<const void*>(&listener)));
+#ifdef FURRY_COMPILER_GCC
+	ASSERT_THAT(it->slowest_handler_name_, ::testing::HasSubstr("Listener"));
+	ASSERT_THAT(it->slowest_handler_name_, ::testing::Not(::testing::StartsWith("Z")));
+#endif
+}
@@ -0,0 +1,208 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+using ::FURRY_NS::Channel;
+using ::FURRY_NS::Config;
+using ::FURRY_NS::ConfigChanged;
+using ::FURRY_NS::ConfigKey;
+using ::FURRY_NS::ConfigParser;
+using ::FURRY_NS::ConfigStore;
+using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::StrEq;
+
+namespace {
+	const char* kConfig =
+		"# comment\n"
+		"[window]\n"
+		"width = 1280\n"
+		"scale=1.5\n"
+		"title = Furry Game \r\n"
+		"\n"
+		"[debug]\n"
+		"; another comment\n"
+		"enabled = false\n"
+		"mode = fast\n";
+
+	struct ChangeRecorder {
+		void operator()(const ConfigChanged& change) {
+			names_.push_back(change.name_);
+		}
+
+		std::vector<std::string> names_;
+	};
+}
+
+TEST(ConfigStore, ValuesAreReadThroughKeys) {
+	ConfigStore store;
+	store.parse(kConfig);
+
+	ASSERT_THAT(store.get(store.key("window", "width"), 0), Eq(1280));
+	ASSERT_THAT(store.get(store.key("window", "scale"), 1.0), Eq(1.5));
+	ASSERT_THAT(store.get(store.key("window", "title"), ""), StrEq("Furry Game"));
+	ASSERT_THAT(store.get(store.key("debug", "enabled"), true), Eq(false));
+}
+
+TEST(ConfigStore, MissingOrMismatchedValuesReturnTheFallback) {
+	ConfigStore store;
+	store.parse(kConfig);
+
+	ASSERT_THAT(store.get(store.key("debug", "mode"), 7), Eq(7));
+	ASSERT_THAT(store.get(store.key("window", "scale"), 7), Eq(7));
+	ASSERT_THAT(store.get(store.find("window", "height"), 720), Eq(720));
+	ASSERT_THAT(store.get(ConfigKey(), 3.0), Eq(3.0));
+}
+
+TEST(ConfigStore, KeysResolvedBeforeLoadingSeeTheValues) {
+	ConfigStore store;
+	ConfigKey width = store.key("window", "width");
+
+	ASSERT_THAT(store.has(width), Eq(false));
+
+	store.parse(kConfig);
+
+	ASSERT_THAT(store.key("window", "width"), Eq(width));
+	ASSERT_THAT(store.get(width, 0), Eq(1280));
+
+	store.set(width, "1920");
+	ASSERT_THAT(store.get(width, 0), Eq(1920));
+}
+
+TEST(ConfigParser, EntriesAreViewsIntoTheText) {
+	std::string text = std::string(kConfig) + "[window]\nwidth = 1920";
+
+	ConfigParser parser;
+	parser.parse(text.data(), text.size());
+
+	ASSERT_THAT(parser.size(), Eq(5u));
+	ASSERT_THAT(parser.find("window", "width")->value_.str(), Eq("1920")); // the last one wins
+	ASSERT_THAT(parser.find("debug", "mode")->value_.data(), Eq(text.data() + text.find("fast")));
+	ASSERT_THAT(parser.find("debug", "width"), IsNull());
+	ASSERT_THAT(parser.entries()[0].section_.str(), Eq("debug"));
+}
+
+TEST(ConfigStore, CachedValuesMatchTheParsedOnes) {
+	const char* kFile = "config-cache-test.ini";
+	const char* kCache = "config-cache-test.ini.cache";
+	std::ofstream(kFile) << kConfig;
+
+	ConfigStore parsed;
+	ASSERT_THAT(parsed.load(kFile, kCache), Eq(true));
+	ASSERT_THAT(std::ifstream(kCache).good(), Eq(true));
+
+	// the last text in the image is the one of window/width; changing it shows the image is used
+	std::ofstream(kCache, std::ios::binary | std::ios::in | std::ios::out).seekp(-1, std::ios::end) << 'X';
+	ConfigStore cached;
+	ASSERT_THAT(cached.load(kFile, kCache), Eq(true));
+
+	ASSERT_THAT(cached.get(cached.key("window", "width"), ""), StrEq("128X"));
+	ASSERT_THAT(cached.get(cached.key("window", "width"), 0), Eq(1280)); // not parsed again
+	ASSERT_THAT(cached.get(cached.key("window", "scale"), 1.0), Eq(1.5));
+	ASSERT_THAT(cached.get(cached.key("debug", "enabled"), true), Eq(false));
+
+	std::ofstream(kFile) << kConfig << "[debug]\nmode = slow\n"; // outdates the image
+	ConfigStore reparsed;
+	ASSERT_THAT(reparsed.load(kFile, kCache), Eq(true));
+	ASSERT_THAT(reparsed.get(reparsed.key("debug", "mode"), ""), StrEq("slow"));
+
+	std::remove(kFile);
+	std::remove(kCache);
+}
+
+TEST(ConfigStore, ConfigSystemReadsByName) {
+	Config config;
+	ASSERT_THAT(config.load("does-not-exist.ini"), Eq(false));
+
+	ASSERT_THAT(config.get<int>("window", "width"), Eq(0));
+	ASSERT_THAT(config.get("window", "title", "Untitled"), Eq("Untitled"));
+	ASSERT_THAT(config.get(config.key("window", "scale"), 2.0), Eq(2.0));
+}
+
+TEST(ConfigStore, NewKeysDoNotReplaceTheSnapshot) {
+	Config config;
+	config.key("window", "width");
+
+	auto before = config.read();
+	ConfigKey depth = config.key("window", "depth");
+
+	ASSERT_THAT(&*config.read(), Eq(&*before));
+	ASSERT_THAT(before->get(depth, 32), Eq(32)); // resolved after the snapshot was taken
+	ASSERT_THAT(config.key("window", "depth"), Eq(depth));
+}
+
+TEST(ConfigStore, ChangedFilesAreReloaded) {
+	const char* kFile = "config-test.ini";
+	std::ofstream(kFile) << kConfig;
+
+	Config config;
+	ASSERT_THAT(config.load(kFile), Eq(true));
+	config.enableHotReload();
+
+	ConfigKey width = config.key("window", "width");
+	ConfigKey height = config.key("window", "height");
+	ASSERT_THAT(config.get(width, 0), Eq(1280));
+
+	ChangeRecorder recorder;
+	Channel::add<ConfigChanged>(&recorder);
+
+	std::ofstream(kFile) << "[window]\nwidth = 1920\nheight = 1080\ntitle = Furry Game\nscale = 1.5\n[debug]\nenabled = false\nmode = fast\n";
+
+	for (int i = 0; i < 20 && config.get(width, 0) == 1280; ++i) {
+		config.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	Channel::dispatch();
+	Channel::remove<ConfigChanged>(&recorder);
+
+	ASSERT_THAT(config.get(width, 0), Eq(1920));
+	ASSERT_THAT(config.get(height, 0), Eq(1080));
+	ASSERT_THAT(recorder.names_, ::testing::UnorderedElementsAre("window/width", "window/height"));
+
+	std::remove(kFile);
+}
+
+TEST(ConfigStore, InitializedConfigsReloadOnTheirOwnThread) {
+	const char* kFile = "config-test.ini";
+	std::ofstream(kFile) << kConfig;
+
+	Config config;
+	ASSERT_THAT(config.load(kFile), Eq(true));
+	config.enableHotReload();
+	ASSERT_THAT(config.initialize(), Eq(true));
+
+	ConfigKey width = config.key("window", "width");
+	ASSERT_THAT(config.get(width, 0), Eq(1280));
+
+	std::ofstream(kFile) << "[window]\nwidth = 1920\n";
+
+	for (int i = 0; i < 20 && config.get(width, 0) == 1280; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	config.shutdown();
+	Channel::dispatch();
+
+	ASSERT_THAT(config.get(width, 0), Eq(1920));
+
+	std::remove(kFile);
+}
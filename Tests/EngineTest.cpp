@@ -0,0 +1,301 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+using ::FURRY_NS::Application;
+using ::FURRY_NS::Channel;
+using ::FURRY_NS::Engine;
+using ::FURRY_NS::System;
+using ::FURRY_NS::TaskProcessor;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+
+namespace {
+	struct Physics : System {
+		explicit Physics(std::string name = "Physics") : System(std::move(name)) {}
+	};
+
+	struct Audio : System {
+		Audio() : System("Audio") {}
+
+		void shutdown() override {
+			++shutdowns_;
+		}
+
+		int shutdowns_ = 0;
+	};
+}
+
+TEST(Engine, SystemsAreFoundByTheirType) {
+	Engine engine;
+
+	auto physics = new Physics;
+	engine.add(physics);
+
+	ASSERT_THAT(engine.get<Physics>(), Eq(physics));
+	ASSERT_THAT(engine.get<Audio>(), Eq(static_cast<Audio*>(nullptr)));
+
+	auto audio = new Audio;
+	engine.add(audio);
+
+	ASSERT_THAT(engine.get<Audio>(), Eq(audio));
+	ASSERT_THAT(engine.get<Physics>(), Eq(physics));
+}
+
+TEST(Engine, RemovedSystemsAreShutDownAndForgotten) {
+	Engine engine;
+
+	auto audio = new Audio;
+	engine.add(new Physics);
+	engine.add(audio);
+
+	engine.remove(engine.get<Physics>());
+	ASSERT_THAT(engine.get<Physics>(), Eq(static_cast<Physics*>(nullptr)));
+	ASSERT_THAT(audio->shutdowns_, Eq(0));
+
+	engine.add(new Physics); // the name is free again
+	ASSERT_THAT(engine.get<Physics>() != nullptr, Eq(true));
+}
+
+TEST(Engine, RemovingTheFirstSystemOfATypeFallsBackToTheNextOne) {
+	Engine engine;
+
+	auto first = new Physics;
+	auto second = new Physics("Physics2");
+	auto audio = new Audio;
+	engine.add(first);
+	engine.add(audio);
+	engine.add(second);
+
+	engine.remove(first);
+	ASSERT_THAT(engine.get<Physics>(), Eq(second));
+
+	engine.remove("Audio");
+	ASSERT_THAT(engine.get<Audio>(), Eq(static_cast<Audio*>(nullptr)));
+
+	engine.remove(second); // moved when the others were removed
+	ASSERT_THAT(engine.get<Physics>(), Eq(static_cast<Physics*>(nullptr)));
+}
+
+TEST(TaskProcessor, GraphTasksRunAfterTheirDependencies) {
+	TaskProcessor processor(3);
+	std::vector<TaskProcessor::GraphTask> tasks(4);
+
+	std::mutex mutex;
+	std::vector<int> order;
+	std::atomic<int> running(0), overlap(0);
+	auto mainThread = std::this_thread::get_id();
+	bool ranOnMainThread = false;
+
+	for (int i = 0; i < 4; ++i) {
+		tasks[i].task_ = [&, i] {
+			if (++running > 1)
+				++overlap;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+			if (i == 3)
+				ranOnMainThread = std::this_thread::get_id() == mainThread;
+
+			--running;
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(i);
+		};
+	}
+
+	// 0 and 1 are independent, 2 needs both, 3 needs 2 and the main thread
+	tasks[2].dependencies_ = { 0, 1 };
+	tasks[3].dependencies_ = { 2 };
+	tasks[3].is_main_thread_only_ = true;
+
+	ASSERT_THAT(processor.runGraph(tasks), Eq(true));
+
+	ASSERT_THAT(order.size(), Eq(4u));
+	ASSERT_THAT(std::vector<int>(order.begin() + 2, order.end()), ElementsAre(2, 3));
+	ASSERT_THAT(overlap.load() > 0, Eq(true)); // 0 and 1 ran concurrently
+	ASSERT_THAT(ranOnMainThread, Eq(true));
+}
+
+TEST(TaskProcessor, CyclicGraphsAreRejected) {
+	TaskProcessor processor(1);
+	std::vector<TaskProcessor::GraphTask> tasks(2);
+
+	int runs = 0;
+	tasks[0].task_ = tasks[1].task_ = [&runs] { ++runs; };
+	tasks[0].dependencies_ = { 1 };
+	tasks[1].dependencies_ = { 0 };
+
+	ASSERT_THAT(processor.runGraph(tasks), Eq(false));
+	ASSERT_THAT(runs, Eq(0));
+}
+
+namespace {
+	// records initialize() and shutdown() calls of the systems sharing the journal
+	struct Journal {
+		std::mutex mutex_;
+		std::vector<std::string> entries_;
+
+		void write(std::string entry) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			entries_.push_back(std::move(entry));
+		}
+	};
+
+	struct Stage : System {
+		Stage(std::string name, Journal& journal, std::vector<std::string> dependencies = {}) :
+			System(std::move(name)),
+			journal_(journal)
+		{
+			for (auto&& dependency : dependencies)
+				addDependency(dependency);
+		}
+
+		bool initialize() override {
+			journal_.write("+" + getName());
+			return true;
+		}
+
+		void shutdown() override {
+			journal_.write("-" + getName());
+		}
+
+		Journal& journal_;
+	};
+
+	// stops the Engine as soon as its main loop runs
+	struct StoppingApplication : Application {
+		StoppingApplication() : Application("StoppingApplication") {}
+
+		bool initialize() override {
+			Channel::post(Engine::OnStop());
+			return true;
+		}
+
+		void render(double) override {}
+		void update(double) override {}
+	};
+}
+
+TEST(Engine, SystemsAreInitializedAfterAndShutDownBeforeTheirDependencies) {
+	Journal journal;
+	{
+		Engine engine;
+		engine.setApplication(new StoppingApplication);
+
+		// added in the opposite order of their dependencies
+		engine.add(new Stage("Renderer", journal, { "Window" }));
+		engine.add(new Stage("Window", journal, { "Platform" }));
+		engine.add(new Stage("Platform", journal));
+
+		engine.run();
+	}
+
+	ASSERT_THAT(journal.entries_, ElementsAre("+Platform", "+Window", "+Renderer", "-Renderer", "-Window", "-Platform"));
+}
+
+TEST(Engine, CyclicDependenciesFallBackToTheOrderSystemsWereAddedIn) {
+	Journal journal;
+	{
+		Engine engine;
+		engine.setApplication(new StoppingApplication);
+
+		engine.add(new Stage("Input", journal, { "Scripting" }));
+		engine.add(new Stage("Scripting", journal, { "Input" }));
+
+		engine.run();
+	}
+
+	// and shut down in reverse
+	ASSERT_THAT(journal.entries_, ElementsAre("+Input", "+Scripting", "-Scripting", "-Input"));
+}
+
+namespace {
+	struct Renderer : System {
+		Renderer() : System("Renderer") {
+			setBudget(std::chrono::microseconds(1000));
+		}
+
+		void update() override {
+			std::this_thread::sleep_for(std::chrono::milliseconds(3));
+		}
+
+		void budgetExceeded(std::chrono::microseconds cost) override {
+			overruns_.push_back(cost);
+		}
+
+		std::vector<std::chrono::microseconds> overruns_;
+	};
+}
+
+TEST(FrameStats, SystemsOverTheirBudgetAreNotified) {
+	using ::FURRY_NS::FrameStats;
+
+	FrameStats stats;
+	Renderer renderer;
+	FrameStats::Counter* cost = stats.counter("Renderer", &renderer);
+	FrameStats::Counter* audio = stats.counter("Audio");
+
+	ASSERT_THAT(stats.counter("Renderer"), Eq(cost));
+
+	stats.endFrame(); // first frame boundary
+	for (int frame = 0; frame < 3; ++frame) {
+		{
+			FrameStats::Scope scope(cost);
+			renderer.update();
+		}
+		audio->add(0);
+		stats.endFrame();
+	}
+
+	ASSERT_THAT(renderer.overruns_.size(), Eq(3u));
+	ASSERT_THAT(renderer.overruns_[0] >= std::chrono::microseconds(3000), Eq(true));
+
+	auto snapshot = stats.snapshot();
+	ASSERT_THAT(snapshot.frames_, Eq(3u));
+	ASSERT_THAT(snapshot.p50_ms_ >= 3.0, Eq(true));
+	ASSERT_THAT(snapshot.entries_.size(), Eq(2u));
+	ASSERT_THAT(snapshot.entries_[0].name_, Eq("Renderer"));
+	ASSERT_THAT(snapshot.entries_[0].overruns_, Eq(3u));
+	ASSERT_THAT(snapshot.entries_[0].budget_ms_, Eq(1.0));
+	ASSERT_THAT(snapshot.entries_[0].average_ms_ >= 3.0, Eq(true));
+}
+
+TEST(FrameStats, CountersAreReattachedToSystemsAddedAgain) {
+	using ::FURRY_NS::FrameStats;
+
+	FrameStats stats;
+	Renderer removed, added;
+	FrameStats::Counter* cost = stats.counter("Renderer", &removed);
+
+	stats.detach(&removed);
+	ASSERT_THAT(stats.counter("Renderer", &added), Eq(cost));
+
+	stats.endFrame();
+	{
+		FrameStats::Scope scope(cost);
+		added.update();
+	}
+	stats.endFrame();
+
+	ASSERT_THAT(removed.overruns_.size(), Eq(0u));
+	ASSERT_THAT(added.overruns_.size(), Eq(1u));
+}
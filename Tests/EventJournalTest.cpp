@@ -0,0 +1,117 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#include <gmock/gmock.h>
+
+using ::FURRY_NS::Channel;
+using ::FURRY_NS::EventRecorder;
+using ::FURRY_NS::EventReplayer;
+using ::FURRY_NS::GLFWApplication;
+using ::FURRY_NS::MessageHandler;
+using ::testing::Eq;
+using ::testing::ElementsAre;
+
+namespace {
+	const char* kJournal = "eventjournal-test.bin";
+
+	struct Damage {
+		int amount_;
+	};
+
+	struct DamageLog : MessageHandler<Damage> {
+		void operator()(const Damage& damage) override {
+			amounts_.push_back(damage.amount_);
+		}
+		std::vector<int> amounts_;
+	};
+
+	struct MoveLog : MessageHandler<GLFWApplication::MouseMoveInput> {
+		void operator()(const GLFWApplication::MouseMoveInput& move) override {
+			xs_.push_back(move.x_);
+		}
+		std::vector<double> xs_;
+	};
+}
+
+TEST(EventJournal, ReplaysRecordedEventsInOrder) {
+	{
+		EventRecorder recorder(kJournal);
+		recorder.record<Damage>(1);
+		recorder.recordInput();
+
+		Channel::broadcast(Damage{ 10 });
+		Channel::broadcast(GLFWApplication::MouseMoveInput{ 1.5, 2.0 });
+		Channel::broadcast(Damage{ 20 });
+	}
+
+	DamageLog damage;
+	MoveLog moves;
+
+	EventReplayer replayer(kJournal);
+	replayer.replay<Damage>(1);
+	replayer.replayInput();
+
+	ASSERT_THAT(replayer.run(EventReplayer::Timing::AsFastAsPossible), Eq(3u));
+	ASSERT_THAT(damage.amounts_, ElementsAre(10, 20));
+	ASSERT_THAT(moves.xs_, ElementsAre(1.5));
+
+	std::remove(kJournal);
+}
+
+TEST(EventJournal, SkipsTypesThatAreNotReplayed) {
+	{
+		EventRecorder recorder(kJournal);
+		recorder.record<Damage>(1);
+		Channel::broadcast(Damage{ 10 });
+	}
+
+	EventReplayer replayer(kJournal);
+	ASSERT_THAT(replayer.run(EventReplayer::Timing::AsFastAsPossible), Eq(0u));
+
+	std::remove(kJournal);
+}
+
+TEST(EventJournal, StopsAtRecordsWithAnImpossibleSize) {
+	{
+		EventRecorder recorder(kJournal);
+		recorder.record<Damage>(1);
+		Channel::broadcast(Damage{ 10 });
+	}
+
+	{
+		// what a crash in the middle of a write can leave behind
+		std::ofstream out(kJournal, std::ios::binary | std::ios::app);
+		std::uint64_t timestamp = 0;
+		std::uint32_t typeId = 1, size = 0xFFFFFFF0;
+		out.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+		out.write(reinterpret_cast<const char*>(&typeId), sizeof(typeId));
+		out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	}
+
+	DamageLog damage;
+
+	EventReplayer replayer(kJournal);
+	replayer.replay<Damage>(1);
+
+	ASSERT_THAT(replayer.run(EventReplayer::Timing::AsFastAsPossible), Eq(1u));
+	ASSERT_THAT(damage.amounts_, ElementsAre(10));
+
+	std::remove(kJournal);
+}
@@ -0,0 +1,403 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+using ::FURRY_NS::FileSinkOptions;
+using ::FURRY_NS::FlightRecorder;
+using ::FURRY_NS::LogBackend;
+using ::FURRY_NS::LogBackpressure;
+using ::FURRY_NS::LogDecoder;
+using ::FURRY_NS::Logger;
+using ::FURRY_NS::LogLevel;
+using ::FURRY_NS::LogMessage;
+using ::FURRY_NS::LogModule;
+using ::FURRY_NS::LogSink;
+using ::FURRY_NS::formatLogArguments;
+using ::FURRY_NS::makeBinaryFileSink;
+using ::FURRY_NS::makeFileSink;
+using ::FURRY_NS::makeMappedFileSink;
+using ::FURRY_NS::MonotonicClock;
+using ::FURRY_NS::setLogLevel;
+using ::FURRY_NS::TaskProcessor;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+namespace {
+	FURRY_LOG_MODULE(gTestModule, "test");
+
+	int gEvaluations = 0;
+
+	int expensive() {
+		return ++gEvaluations;
+	}
+
+	// replaces the default console and file sinks for the lifetime of the object
+	class OnlySink {
+	public:
+		explicit OnlySink(const LogSink& sink) : sink_(sink), defaults_(*Logger::instance().sinks()) {
+			for (auto&& s : defaults_)
+				Logger::instance().remove(s);
+
+			Logger::instance().add(sink_);
+		}
+
+		~OnlySink() {
+			LogBackend::instance().drain();
+			Logger::instance().remove(sink_);
+
+			for (auto&& s : defaults_)
+				Logger::instance().add(s);
+		}
+
+	private:
+		LogSink sink_;
+		Logger::SinkList defaults_;
+	};
+
+	std::string readFile(const char* filename) {
+		std::ifstream in(filename);
+		std::ostringstream content;
+		content << in.rdbuf();
+		return content.str();
+	}
+}
+
+TEST(Logger, ArgumentsOfFilteredStatementsAreNotEvaluated) {
+	gEvaluations = 0;
+	gTestModule.setThreshold(LogLevel::EError);
+
+	gLogModuleLevel(gTestModule, EWarning) << expensive();
+	gFastLogModuleLevel(gTestModule, EMessage) << expensive();
+	ASSERT_THAT(gEvaluations, Eq(0));
+
+	gLogModuleLevel(gTestModule, EError) << expensive();
+	ASSERT_THAT(gEvaluations, Eq(1));
+}
+
+TEST(Logger, StatementsBelowTheCompiledLevelAreRemoved) {
+	gEvaluations = 0;
+	gTestModule.setThreshold(LogLevel::EDebug);
+
+	gLogModuleLevel(gTestModule, EDebug) << expensive();
+	ASSERT_THAT(gEvaluations, Eq(FURRY_LOG_MIN_LEVEL > 0 ? 0 : 1));
+}
+
+TEST(Logger, ModulesCanBeFoundByName) {
+	ASSERT_THAT(LogModule::find("test"), Eq(&gTestModule));
+	ASSERT_THAT(LogModule::find("global"), Eq(&LogModule::global()));
+	ASSERT_THAT(LogModule::find("unknown"), Eq(static_cast<LogModule*>(nullptr)));
+}
+
+TEST(Logger, LimitedStatementsSkipMessagesBeyondTheirBudget) {
+	gEvaluations = 0;
+
+	for (int i = 0; i < 100; ++i)
+		gLogLimited(EWarning, 3) << expensive();
+
+	ASSERT_THAT(gEvaluations, Eq(3));
+}
+
+TEST(Logger, SuppressedMessagesAreReportedWhenTheSiteFallsSilent) {
+	auto report = std::make_shared<std::string>();
+	auto mutex = std::make_shared<std::mutex>();
+	{
+		OnlySink only([report, mutex](const LogMessage::Meta&, const std::string& message) {
+			std::lock_guard<std::mutex> lock(*mutex);
+
+			if (message.find("suppressed") != std::string::npos)
+				*report = message;
+		});
+
+		for (int i = 0; i < 10; ++i)
+			gLogLimited(EWarning, 3) << "storm";
+
+		// the site never fires again, the Logger reports once its window is over
+		for (int i = 0; i < 300; ++i) {
+			{
+				std::lock_guard<std::mutex> lock(*mutex);
+				if (!report->empty())
+					break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	ASSERT_THAT(*report, Eq("(7 similar messages suppressed)"));
+}
+
+TEST(Logger, BlockingBackpressureDoesNotBlockSinksThatLog) {
+	auto delivered = std::make_shared<std::atomic<int>>(0);
+
+	Logger::instance().setBackpressure(LogBackpressure::Block, 1);
+	{
+		OnlySink only([delivered](const LogMessage::Meta&, const std::string&) {
+			if (delivered->fetch_add(1) == 0)
+				gLogError << "logged by a sink"; // the queue is still full with the message being delivered
+		});
+
+		gLogError << "message";
+
+		for (int i = 0; i < 500 && delivered->load() < 1; ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	Logger::instance().setBackpressure(LogBackpressure::Drop, 16 * 1024);
+
+	ASSERT_THAT(delivered->load() >= 1, Eq(true));
+}
+
+TEST(Logger, MissingStructuredArgumentsArePlaceholders) {
+	ASSERT_THAT(formatLogArguments("{} of {}", "", 0), Eq("{?} of {?}"));
+}
+
+TEST(Logger, BinarySinkCanBeDecoded) {
+	const char* kLog = "logger-test.bin";
+	{
+		LogSink sink = makeBinaryFileSink(kLog);
+		Logger::instance().add(sink);
+
+		for (int i = 0; i < 2; ++i)
+			gLogFormat(EError, "Loaded {} sprites in {} ms from {} ({})", 42 + i, 1.5, std::string("atlas.png"), true);
+
+		LogBackend::instance().drain();
+		Logger::instance().remove(sink);
+	}
+
+	std::ifstream in(kLog, std::ios::binary);
+	std::ostringstream out;
+
+	ASSERT_THAT(LogDecoder(in).decode(out), Eq(2u));
+	ASSERT_THAT(out.str(), HasSubstr("Loaded 42 sprites in 1.5 ms from atlas.png (true)"));
+	ASSERT_THAT(out.str(), HasSubstr("Loaded 43 sprites"));
+
+	in.close();
+	std::remove(kLog);
+}
+
+TEST(Logger, StructuredStringsKeepEmbeddedZeros) {
+	auto received = std::make_shared<std::string>();
+	LogSink sink = [received](const LogMessage::Meta&, const std::string& message) {
+		*received = message;
+	};
+
+	{
+		OnlySink only(sink);
+		gLogFormat(EError, "payload {}", std::string("a\0b", 3));
+	}
+
+	ASSERT_THAT(*received, Eq(std::string("payload a\0b", 11)));
+}
+
+TEST(Logger, FileSinkBuffersUntilAnError) {
+	const char* kLog = "logger-test.log";
+	{
+		LogSink sink = makeFileSink(kLog);
+
+		sink.forward(LogMessage::Meta{ LogLevel::EMessage, "file.cpp", 1, MonotonicClock::ticks() }, "buffered");
+		ASSERT_THAT(readFile(kLog), Eq(""));
+
+		sink.forward(LogMessage::Meta{ LogLevel::EError, "file.cpp", 2, MonotonicClock::ticks() }, "flushed");
+		ASSERT_THAT(readFile(kLog), HasSubstr("buffered (file.cpp:1)"));
+		ASSERT_THAT(readFile(kLog), HasSubstr("flushed (file.cpp:2)"));
+	}
+	std::remove(kLog);
+}
+
+TEST(Logger, FileSinkFlushesAfterTheIntervalWithoutFurtherMessages) {
+	const char* kLog = "logger-test-idle.log";
+
+	FileSinkOptions options;
+	options.flush_interval_ = std::chrono::milliseconds(50);
+	{
+		OnlySink only(makeFileSink(kLog, options));
+		gLog << "the last line before a quiet period";
+
+		// polled by the Logger, nothing else is logged meanwhile
+		for (int i = 0; i < 100 && readFile(kLog).empty(); ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		ASSERT_THAT(readFile(kLog), HasSubstr("the last line before a quiet period"));
+	}
+	std::remove(kLog);
+}
+
+TEST(Logger, FileSinkKeepsAtMostMaxFiles) {
+	FileSinkOptions options;
+	options.max_file_size_ = 100;
+	options.max_files_ = 2;
+	options.flush_level_ = LogLevel::EDebug; // flush (and maybe rotate) after every message
+	{
+		LogSink sink = makeFileSink("logger-test.log", options);
+
+		for (int i = 0; i < 10; ++i)
+			sink.forward(LogMessage::Meta{ LogLevel::EMessage, "file.cpp", i, MonotonicClock::ticks() }, "message");
+	}
+
+	ASSERT_THAT(readFile("logger-test.log"), HasSubstr("(file.cpp:9)"));
+	ASSERT_THAT(readFile("logger-test.1.log"), HasSubstr("message"));
+	ASSERT_THAT(std::ifstream("logger-test.2.log").good(), Eq(false));
+
+	std::remove("logger-test.log");
+	std::remove("logger-test.1.log");
+}
+
+TEST(Logger, MappedFileSinkGrowsAndMarksACleanShutdown) {
+	const char* kLog = "logger-test-mapped.log";
+	{
+		LogSink sink = makeMappedFileSink(kLog, 1); // rounded up to a page, so this needs several chunks
+
+		for (int i = 0; i < 500; ++i)
+			sink.forward(LogMessage::Meta{ LogLevel::EMessage, "file.cpp", i, MonotonicClock::ticks() }, "message");
+	}
+
+	std::string content = readFile(kLog);
+	ASSERT_THAT(content, HasSubstr("(file.cpp:0)"));
+	ASSERT_THAT(content, HasSubstr("(file.cpp:499)"));
+	ASSERT_THAT(content.find('\0'), Eq(std::string::npos));
+	ASSERT_THAT(content.substr(content.size() - 27), Eq("--- log closed cleanly ---\n"));
+
+	std::remove(kLog);
+}
+
+TEST(Logger, SinksCanBeChangedWhileLogging) {
+	auto delivered = std::make_shared<std::atomic<int>>(0);
+	auto churned = std::make_shared<std::atomic<int>>(0);
+
+	LogSink sink = [churned](const LogMessage::Meta&, const std::string&) {
+		++*churned;
+	};
+	{
+		OnlySink only([delivered](const LogMessage::Meta&, const std::string&) {
+			++*delivered;
+		});
+
+		std::thread logging([] {
+			for (int i = 0; i < 200; ++i)
+				gLogError << "message " << i;
+		});
+
+		for (int i = 0; i < 200; ++i) {
+			Logger::instance().add(sink);
+			Logger::instance().remove(sink);
+		}
+
+		logging.join();
+
+		// delivery happens on the Logger's Active
+		for (int i = 0; i < 500 && delivered->load() < 200; ++i)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		ASSERT_THAT(delivered->load(), Eq(200));
+		ASSERT_THAT(churned->load() <= 200, Eq(true));
+	}
+
+	ASSERT_THAT(Logger::instance().sinks()->size(), Eq(2u)); // console and file
+}
+
+TEST(Logger, FlightRecorderKeepsLevelsDisabledForTheSinks) {
+	const char* kDump = "flightrecorder-test.bin";
+
+	FlightRecorder::setEnabled(true);
+	setLogLevel(LogLevel::EMessage, false);
+
+	gLogMessage << "context " << 1;
+	gFastLogMessage << "context " << 2;
+	gLogFormat(EMessage, "context {}", 3);
+	FlightRecorder::markFrame();
+
+	setLogLevel(LogLevel::EMessage, true);
+	FlightRecorder::setEnabled(false);
+
+	ASSERT_THAT(FlightRecorder::dump(kDump), Eq(true));
+
+	std::ifstream in(kDump, std::ios::binary);
+	std::ostringstream out;
+	LogDecoder(in).decode(out);
+
+	ASSERT_THAT(out.str(), HasSubstr("context 1"));
+	ASSERT_THAT(out.str(), HasSubstr("context 2"));
+	ASSERT_THAT(out.str(), HasSubstr("context 3"));
+	ASSERT_THAT(out.str(), HasSubstr("--- frame"));
+
+	in.close();
+	std::remove(kDump);
+}
+
+TEST(FlightRecorder, TasksAreRecordedByTheirLabel) {
+	const char* kDump = "flightrecorder-tasks.bin";
+
+	TaskProcessor processor(1);
+	processor.addWork([&] { processor.stop(); }, false, false, "stopping task");
+
+	FlightRecorder::setEnabled(true);
+	processor.start();
+	FlightRecorder::setEnabled(false);
+
+	ASSERT_THAT(FlightRecorder::dump(kDump), Eq(true));
+
+	std::ifstream in(kDump, std::ios::binary);
+	std::ostringstream out;
+	LogDecoder(in).decode(out);
+
+	ASSERT_THAT(out.str(), HasSubstr("stopping task"));
+
+	in.close();
+	std::remove(kDump);
+}
+
+#ifndef FURRY_PLATFORM_WINDOWS
+namespace {
+	volatile int gOverflowLimit = -1; // never reached, but the compiler cannot know that
+
+	int overflow(int depth) {
+		volatile char frame[1024];
+		frame[0] = static_cast<char>(depth);
+
+		if (depth == gOverflowLimit)
+			return frame[0];
+
+		return overflow(depth + 1) + frame[0]; // not a tail call
+	}
+}
+
+TEST(FlightRecorder, StackOverflowsAreDumped) {
+	const char* kDump = "flightrecorder-overflow.bin";
+	std::remove(kDump);
+
+	ASSERT_DEATH({
+		FlightRecorder::setEnabled(true);
+		FlightRecorder::installCrashHandler(kDump);
+		FlightRecorder::recordEvent("before the overflow", __FILE__, __LINE__);
+		overflow(0);
+	}, "");
+
+	std::ifstream in(kDump, std::ios::binary);
+	std::ostringstream out;
+	LogDecoder(in).decode(out);
+
+	ASSERT_THAT(out.str(), HasSubstr("before the overflow"));
+
+	in.close();
+	std::remove(kDump);
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+* ****************************************
+*
+* This file is part of Furry2D, a simple gameframework for 2D desktop games.
+*
+* Copyright (c) 2015 Furry2D. All rights reserved.
+*
+* For the full copyright and license information, please view the LICENSE.txt
+* file that was distributed with this source code.
+*
+* \Author Alexander Knueppel
+*
+* ****************************************
+*/
+
+#include <furry2d/furry2d.h>
+#include <sstream>
+#include <thread>
+
+#include <gmock/gmock.h>
+
+using ::FURRY_NS::Profiler;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+namespace {
+	size_t count(const std::string& text, const std::string& pattern) {
+		size_t result = 0;
+
+		for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+			++result;
+
+		return result;
+	}
+
+	void nested() {
+		FURRY_PROFILE_ZONE("outer");
+		{
+			FURRY_PROFILE_ZONE("inner");
+		}
+	}
+}
+
+#if FURRY_PROFILE // needs the zones compiled in
+TEST(Profiler, NestedZonesOfAllThreadsAreExported) {
+	Profiler::clear();
+	Profiler::setEnabled(true);
+
+	nested();
+
+	std::thread worker([] {
+		Profiler::setThreadName("worker");
+		nested();
+	});
+	worker.join(); // the buffer of an exited thread is still exported
+
+	Profiler::setEnabled(false);
+
+	std::ostringstream trace;
+	ASSERT_THAT(Profiler::writeChromeTrace(trace), Eq(4u));
+
+	std::string json = trace.str();
+	ASSERT_THAT(json.find("{\"traceEvents\":["), Eq(0u));
+	ASSERT_THAT(count(json, "\"ph\":\"B\""), Eq(4u));
+	ASSERT_THAT(count(json, "\"ph\":\"E\""), Eq(4u));
+	ASSERT_THAT(count(json, "\"name\":\"inner\""), Eq(2u));
+	ASSERT_THAT(json, HasSubstr("\"args\":{\"name\":\"worker\"}"));
+
+	// drained by the export
+	std::ostringstream empty;
+	ASSERT_THAT(Profiler::writeChromeTrace(empty), Eq(0u));
+}
+#endif
+
+TEST(Profiler, NothingIsRecordedWhileDisabled) {
+	Profiler::clear();
+
+	nested();
+
+	std::ostringstream trace;
+	ASSERT_THAT(Profiler::writeChromeTrace(trace), Eq(0u));
+	ASSERT_THAT(trace.str(), Not(HasSubstr("outer")));
+}
+
+#if FURRY_PROFILE
+TEST(Profiler, FullBuffersDropWholeZones) {
+	Profiler::clear();
+	Profiler::setEnabled(true);
+
+	{
+		FURRY_PROFILE_ZONE("open");
+
+		for (size_t i = 0; i < Profiler::kCapacity; ++i)
+			nested();
+	}
+
+	Profiler::setEnabled(false);
+
+	std::ostringstream trace;
+	size_t zones = Profiler::writeChromeTrace(trace);
+
+	ASSERT_THAT(zones < 2 * Profiler::kCapacity, Eq(true));
+	ASSERT_THAT(count(trace.str(), "\"ph\":\"B\""), Eq(zones));
+	ASSERT_THAT(count(trace.str(), "\"ph\":\"E\""), Eq(zones)); // every recorded zone is closed, also "open"
+}
+#endif
@@ -17,6 +17,7 @@
 #include <chrono>
 #include <gmock/gmock.h>
 
+using ::FURRY_NS::MonotonicClock;
 using ::FURRY_NS::Timer;
 using ::testing::Eq;
 using ::testing::A;
@@ -47,3 +48,14 @@ TEST(Timer, ResetWorksProperly) {
 	EXPECT_NEAR(timer.elapsed().count(), 0, max_diff);
 	std::this_thread::sleep_for(sec);
 }
+
+TEST(Timer, MonotonicTicksConvertToWallClockTime) {
+	using Ms = std::chrono::milliseconds;
+	auto ticks = MonotonicClock::ticks();
+
+	long long wall = std::chrono::duration_cast<Ms>(std::chrono::system_clock::now().time_since_epoch()).count();
+	long long converted = std::chrono::duration_cast<Ms>(MonotonicClock::toSystemTime(ticks).time_since_epoch()).count();
+
+	EXPECT_NEAR(wall, converted, 5);
+	EXPECT_GE(MonotonicClock::ticks(), ticks);
+}
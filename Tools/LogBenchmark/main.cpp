@@ -0,0 +1,252 @@
+#include <furry2d/furry2d.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifdef _DEBUG
+#	pragma comment(lib, "../../bin/Debug/furry2dD.lib")
+#else
+#	pragma comment(lib, "../../bin/Release/furry2d.lib")
+#endif
+
+// Drives Logger::instance() with a configurable load and reports what logging costs:
+//
+//   LogBenchmark [--messages N] [--threads T] [--size bytes] [--sinks null,file,mapped,console]
+//                [--frontend stream|fast|format]
+//
+// stream = gLogMessage, fast = gFastLogMessage, format = gLogFormat. Allocations are counted
+// by replacing the global operator new, which (with a DLL build of furry2d) only sees the
+// allocations made through this executable's heap, e.g. the ones inlined into the call site.
+
+using furry2d::MonotonicClock;
+
+namespace {
+	std::atomic<std::uint64_t> gAllocations(0);
+	thread_local std::uint64_t tAllocations = 0; // of the current thread
+
+	struct Options {
+		size_t messages_ = 200000;
+		size_t threads_ = 1;
+		size_t size_ = 64;
+		std::string sinks_ = "null";
+		std::string frontend_ = "stream";
+	};
+
+	// called on the Logger's or the backend's thread (never both in one run), after the measured sinks
+	struct Probe {
+		explicit Probe(size_t expected) : lag_(expected), delivered_(0), last_(0), is_closed_(false) {}
+
+		std::mutex mutex_; // uncontended until close()
+		std::vector<std::uint64_t> lag_; // ticks between call site and delivery
+		std::atomic<size_t> delivered_;
+		std::atomic<std::uint64_t> last_;
+		bool is_closed_;
+
+		// deliveries of sink snapshots taken before the probe was removed may still arrive
+		void close() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			is_closed_ = true;
+		}
+	};
+
+	bool parse(int argc, char** argv, Options& options) {
+		for (int i = 1; i + 1 < argc; i += 2) {
+			std::string key = argv[i];
+			const char* value = argv[i + 1];
+
+			if (key == "--messages")
+				options.messages_ = std::strtoul(value, nullptr, 10);
+			else if (key == "--threads")
+				options.threads_ = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+			else if (key == "--size")
+				options.size_ = std::strtoul(value, nullptr, 10);
+			else if (key == "--sinks")
+				options.sinks_ = value;
+			else if (key == "--frontend")
+				options.frontend_ = value;
+			else
+				return false;
+		}
+
+		return argc % 2 == 1 && options.messages_ > 0;
+	}
+
+	double nanoseconds(std::uint64_t ticks) {
+		return static_cast<double>(MonotonicClock::toDuration(ticks).count());
+	}
+
+	void report(const char* name, std::vector<std::uint64_t>& ticks) {
+		if (ticks.empty())
+			return;
+
+		std::sort(ticks.begin(), ticks.end());
+
+		// nearest rank
+		auto at = [&ticks](double percentile) {
+			size_t rank = static_cast<size_t>(std::ceil(percentile * ticks.size()));
+			return nanoseconds(ticks[std::min(std::max<size_t>(rank, 1), ticks.size()) - 1]);
+		};
+
+		std::printf("%-14s p50 %10.0f  p90 %10.0f  p99 %10.0f  p99.9 %10.0f  max %10.0f ns\n",
+			name, at(0.5), at(0.9), at(0.99), at(0.999), nanoseconds(ticks.back()));
+	}
+}
+
+void* operator new(size_t size) {
+	++gAllocations;
+	++tAllocations;
+
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) {
+	std::free(p);
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse(argc, argv, options)) {
+		std::cerr << "Usage: LogBenchmark [--messages N] [--threads T] [--size bytes] "
+			"[--sinks null,file,mapped,console] [--frontend stream|fast|format]" << std::endl;
+		return 1;
+	}
+
+	auto& logger = furry2d::Logger::instance();
+
+	// replace the default sinks by the requested ones
+	auto defaults = *logger.sinks();
+	for (auto&& sink : defaults)
+		logger.remove(sink);
+
+	std::stringstream sinks(options.sinks_);
+	for (std::string name; std::getline(sinks, name, ',');) {
+		if (name == "null")
+			logger.add([](const furry2d::LogMessage::Meta&, const std::string&) {});
+		else if (name == "file")
+			logger.add(furry2d::makeFileSink("LogBenchmark.log"));
+		else if (name == "mapped")
+			logger.add(furry2d::makeMappedFileSink("LogBenchmark-mapped.log"));
+		else if (name == "console")
+			logger.add(furry2d::makeConsoleSink());
+		else {
+			std::cerr << "Unknown sink " << name << std::endl;
+			return 1;
+		}
+	}
+
+	size_t perThread = options.messages_ / options.threads_;
+	size_t total = perThread * options.threads_;
+
+	auto probe = std::make_shared<Probe>(total);
+	furry2d::LogSink probeSink = [probe](const furry2d::LogMessage::Meta& meta, const std::string&) {
+		auto now = MonotonicClock::ticks();
+
+		std::lock_guard<std::mutex> lock(probe->mutex_);
+		if (probe->is_closed_)
+			return;
+
+		size_t index = probe->delivered_.load(std::memory_order_relaxed);
+
+		if (index < probe->lag_.size())
+			probe->lag_[index] = now - meta.timestamp_;
+
+		probe->last_.store(now, std::memory_order_relaxed);
+		probe->delivered_.store(index + 1, std::memory_order_release);
+	};
+	logger.add(probeSink);
+
+	// the stream frontend may not lose anything, otherwise lag and throughput are meaningless
+	logger.setBackpressure(furry2d::LogBackpressure::Block, 16 * 1024);
+
+	std::string payload(options.size_, 'x');
+	const char* text = payload.c_str();
+	int frontend = options.frontend_ == "fast" ? 1 : options.frontend_ == "format" ? 2 : 0;
+
+	std::vector<std::vector<std::uint64_t>> latencies(options.threads_, std::vector<std::uint64_t>(perThread));
+	std::vector<std::uint64_t> allocations(options.threads_);
+	std::vector<std::thread> threads;
+
+	auto start = MonotonicClock::ticks();
+
+	for (size_t t = 0; t < options.threads_; ++t) {
+		threads.emplace_back([&, t] {
+			auto& latency = latencies[t];
+			std::uint64_t before = tAllocations;
+
+			for (size_t i = 0; i < perThread; ++i) {
+				auto begin = MonotonicClock::ticks();
+
+				switch (frontend) {
+				case 0: gLogMessage << text << ' ' << i; break;
+				case 1: gFastLogMessage << text << ' ' << i; break;
+				case 2: gLogFormat(EMessage, "{} {}", text, i); break;
+				}
+
+				latency[i] = MonotonicClock::ticks() - begin;
+			}
+
+			allocations[t] = tAllocations - before;
+		});
+	}
+
+	for (auto&& thread : threads)
+		thread.join();
+
+	auto produced = MonotonicClock::ticks();
+
+	// wait for the sinks; the ring buffer frontends drop messages when a ring is full, so stop
+	// once nothing arrived for a while
+	for (size_t seen = 0;;) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+		size_t delivered = probe->delivered_.load(std::memory_order_acquire);
+		if (delivered >= total || delivered == seen)
+			break;
+
+		seen = delivered;
+	}
+
+	// stop measuring before the results are read
+	logger.remove(probeSink);
+	probe->close();
+
+	size_t delivered = std::min(probe->delivered_.load(std::memory_order_acquire), total);
+	double produceSeconds = nanoseconds(produced - start) / 1e9;
+	double deliverSeconds = nanoseconds(probe->last_.load() - start) / 1e9;
+
+	std::vector<std::uint64_t> latency;
+	for (auto&& l : latencies)
+		latency.insert(latency.end(), l.begin(), l.end());
+
+	std::uint64_t callSiteAllocations = 0;
+	for (auto a : allocations)
+		callSiteAllocations += a;
+
+	std::printf("\n%zu messages of %zu bytes from %zu thread(s), frontend %s, sinks %s\n\n",
+		total, options.size_, options.threads_, options.frontend_.c_str(), options.sinks_.c_str());
+
+	report("call site", latency);
+	probe->lag_.resize(delivered);
+	report("backend lag", probe->lag_);
+
+	std::printf("\nproduced       %12.0f msgs/s\n", total / produceSeconds);
+	std::printf("delivered      %12.0f msgs/s (%zu of %zu, %zu lost)\n", delivered / deliverSeconds, delivered, total, total - delivered);
+	std::printf("allocations    %12.2f per message at the call site, %.2f in total\n",
+		static_cast<double>(callSiteAllocations) / total,
+		static_cast<double>(gAllocations.load()) / total);
+
+	return 0;
+}
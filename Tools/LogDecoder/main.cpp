@@ -0,0 +1,37 @@
+#include <furry2d/furry2d.h>
+#include <fstream>
+
+#ifdef _DEBUG
+#	pragma comment(lib, "../../bin/Debug/furry2dD.lib")
+#else
+#	pragma comment(lib, "../../bin/Release/furry2d.lib")
+#endif
+
+// Prints a log written by furry2d::makeBinaryFileSink as text
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: LogDecoder <binary log> [output file]" << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in.good()) {
+		std::cerr << "Failed to open " << argv[1] << std::endl;
+		return 1;
+	}
+
+	try {
+		if (argc > 2) {
+			std::ofstream out(argv[2]);
+			furry2d::LogDecoder(in).decode(out);
+		}
+		else
+			furry2d::LogDecoder(in).decode(std::cout);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}